@@ -0,0 +1,47 @@
+#pragma once
+
+/**
+* Author: Ryley Robinson
+*
+* batch.h: Output of the multithreaded batch generator, and the canonical forms it uses to skip equivalent boards.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+
+// One generated board and the solution it was derived from
+struct GeneratedPuzzle
+{
+    int solved[9][9];
+    int unsolved[9][9];
+};
+
+// A board in canonical form (see canonicalBoard), four bits per space. Two boards have the same key exactly when
+// one can be turned into the other by the transformations the generator uses.
+struct CanonicalKey
+{
+    uint64_t words[6];
+
+    bool operator==(const CanonicalKey& other_) const
+    {
+        for (int i = 0; i < 6; i++)
+        {
+            if (words[i] != other_.words[i]) return false;
+        }
+        return true;
+    }
+};
+
+struct CanonicalKeyHash
+{
+    size_t operator()(const CanonicalKey& key_) const
+    {
+        uint64_t hash = 0;
+        for (int i = 0; i < 6; i++) hash = (hash ^ key_.words[i]) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(hash ^ (hash >> 32));
+    }
+};
+
+// Canonical forms of boards already generated, so that later batches can skip boards equivalent to them
+typedef std::unordered_set<CanonicalKey, CanonicalKeyHash> CanonicalSet;
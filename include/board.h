@@ -0,0 +1,68 @@
+#pragma once
+
+/**
+* Author: Ryley Robinson
+*
+* board.h: Compact value type for a 9 x 9 board, one byte per space.
+*
+* A Board is 81 contiguous bytes, aligned to a cache line and padded to two of them, so copying or comparing one is a
+* single memcpy or memcmp instead of a loop over 81 ints. Spaces are numbered 0 to 80, row by row, and the tables
+* below give the row, column and square of each one without any division.
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "grid.h"
+
+namespace BoardIndex
+{
+    struct Tables
+    {
+        uint8_t row[81];
+        uint8_t col[81];
+        uint8_t square[81];
+    };
+
+    constexpr Tables makeTables()
+    {
+        Tables tables = {};
+        for (int i = 0; i < 81; i++)
+        {
+            tables.row[i] = static_cast<uint8_t>(i / 9);
+            tables.col[i] = static_cast<uint8_t>(i % 9);
+            tables.square[i] = static_cast<uint8_t>(3 * (i / 27) + (i % 9) / 3);
+        }
+        return tables;
+    }
+
+    inline constexpr Tables tables = makeTables();
+
+    // The spaces of each row, column and square, in the same numbering as Grid::units<3>
+    inline constexpr const Grid::UnitTables<3>& units = Grid::units<3>;
+}
+
+struct alignas(64) Board
+{
+    // Digit in each space, 0 if it is empty
+    uint8_t cells[81];
+
+    uint8_t& operator()(int row_, int col_) { return cells[9 * row_ + col_]; }
+    uint8_t operator()(int row_, int col_) const { return cells[9 * row_ + col_]; }
+
+    void load(int board_[9][9])
+    {
+        for (int i = 0; i < 81; i++) cells[i] = static_cast<uint8_t>(board_[i / 9][i % 9]);
+    }
+
+    void store(int board_[9][9]) const
+    {
+        for (int i = 0; i < 81; i++) board_[i / 9][i % 9] = cells[i];
+    }
+
+    bool operator==(const Board& other_) const { return std::memcmp(cells, other_.cells, sizeof(cells)) == 0; }
+    bool operator!=(const Board& other_) const { return !(*this == other_); }
+};
+
+static_assert(std::is_trivially_copyable<Board>::value, "Boards are copied with memcpy");
+static_assert(sizeof(Board) == 128, "A board should take exactly two cache lines");
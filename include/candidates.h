@@ -0,0 +1,97 @@
+#pragma once
+
+/**
+* Author: Ryley Robinson
+*
+* candidates.h: Bitmask representation of the possible digits in each space of the board.
+* Bit (n - 1) of a mask is set when digit n is still possible, so all nine possibilities of a 9 x 9 board fit in one 16-bit word.
+*/
+
+#include <cstdint>
+#include "grid.h"
+
+// Shorthand for the standard 9 x 9 board
+namespace Cand
+{
+    typedef Grid::Traits<3>::Mask Mask;
+
+    const Mask allDigits = Grid::Traits<3>::allDigits;
+
+    // Number of possible digits in a mask
+    inline int countDigits(Mask mask_)
+    {
+        return Grid::countDigits(mask_);
+    }
+
+    // Lowest possible digit in a non-empty mask
+    inline int firstDigit(Mask mask_)
+    {
+        return Grid::firstDigit(mask_);
+    }
+
+    inline Mask digitMask(int n_)
+    {
+        return Grid::digitMask<Mask>(n_);
+    }
+
+    inline int squareOf(int row_, int col_)
+    {
+        return Grid::squareOf<3>(row_, col_);
+    }
+
+    // Units 0-8 are rows, 9-17 are columns and 18-26 are squares. Each space has 20 peers.
+    inline constexpr const Grid::UnitTables<3>& units = Grid::units<3>;
+}
+
+/*
+* The working board used by the solving algorithms.
+* Each space holds a mask of its possible digits, and each row, column and square holds a mask of
+* the digits already solved inside it. Nothing here allocates, so the whole board lives on the stack.
+*/
+template <int Box>
+struct BasicCandidateBoard
+{
+    typedef Grid::Traits<Box> T;
+    typedef typename T::Mask Mask;
+
+    Mask cells[T::cells];
+    Mask rowUsed[T::size];
+    Mask colUsed[T::size];
+    Mask squUsed[T::size];
+
+    // Marks the known digits of board_ as solved, and fills in the possible digits of every other space
+    void load(int board_[T::size][T::size])
+    {
+        for (int i = 0; i < T::size; i++) rowUsed[i] = colUsed[i] = squUsed[i] = 0;
+
+        for (int i = 0; i < T::cells; i++)
+        {
+            int n = board_[i / T::size][i % T::size];
+            cells[i] = n != 0 ? Grid::digitMask<Mask>(n) : T::allDigits;
+            if (n != 0) markSolved(i);
+        }
+
+        for (int i = 0; i < T::cells; i++)
+        {
+            if (board_[i / T::size][i % T::size] == 0) cells[i] &= ~used(i);
+        }
+    }
+
+    // Records the single remaining digit of a space in its row, column and square
+    void markSolved(int index_)
+    {
+        int row = index_ / T::size, col = index_ % T::size;
+        rowUsed[row] |= cells[index_];
+        colUsed[col] |= cells[index_];
+        squUsed[Grid::squareOf<Box>(row, col)] |= cells[index_];
+    }
+
+    // Digits already solved in the row, column or square of a space
+    Mask used(int index_) const
+    {
+        int row = index_ / T::size, col = index_ % T::size;
+        return rowUsed[row] | colUsed[col] | squUsed[Grid::squareOf<Box>(row, col)];
+    }
+};
+
+typedef BasicCandidateBoard<3> CandidateBoard;
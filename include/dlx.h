@@ -0,0 +1,61 @@
+#pragma once
+
+/**
+* Author: Ryley Robinson
+*
+* dlx.h: Exact cover solver using Knuth's Algorithm X with dancing links.
+*
+* Sudoku is modelled as the standard 729 x 324 exact cover matrix. Each row is one digit in one space,
+* and each column is one constraint: a space is filled, or a row/column/square contains a digit.
+* The full matrix is linked once in the constructor. Givens and guesses only unlink and relink nodes,
+* so a search never allocates.
+*/
+
+#include <cstdint>
+#include "search.h"
+
+class DlxSolver
+{
+public:
+    DlxSolver();
+
+    // Solves the board in place. Returns true if solved.
+    bool solve(int board_[9][9], SearchStats* stats_ = nullptr);
+
+    // Counts the solutions of the board, stopping once limit_ have been found. Does not modify the board.
+    int countSolutions(int board_[9][9], int limit_, SearchStats* stats_ = nullptr);
+
+private:
+    static const int nColumns = 324;
+    static const int nRows = 729;
+    static const int root = 0;
+    static const int nNodes = 1 + nColumns + 4 * nRows;
+
+    int left[nNodes];
+    int right[nNodes];
+    int up[nNodes];
+    int down[nNodes];
+    int column[nNodes];
+    int rowOf[nNodes];
+    int size[1 + nColumns];
+
+    // Rows chosen on the current search path
+    int path[81];
+
+    // Digits of the first solution found, by space
+    uint8_t solution[81];
+    bool solutionFound;
+
+    // Columns covered by the givens, in order, so they can be uncovered in reverse
+    int givenColumns[nColumns];
+    int nGivenColumns;
+
+    void cover(int column_);
+    void uncover(int column_);
+
+    // Selects the row of every given digit. Returns false if two givens conflict.
+    bool applyGivens(int board_[9][9]);
+    void removeGivens();
+
+    int search(int depth_, int limit_, SearchStats* stats_);
+};
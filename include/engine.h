@@ -0,0 +1,108 @@
+#pragma once
+
+/**
+* Author: Ryley Robinson
+*
+* engine.h: Iterative backtracking search that can be paused, bounded, cancelled and resumed.
+*
+* The search is the same as searchSolve, on the same SearchState: place every naked and hidden single, then guess in
+* the empty space with the fewest possible digits. Instead of recursing and copying the state at each guess, it keeps
+* an explicit stack of choice points and a trail of the spaces filled in since each one. Backing out of a guess empties the spaces on the
+* trail back to its mark, which frees their digits in the row, column and square masks again.
+*
+* Since the whole search lives in the object, run() can stop anywhere, after a node budget, a time limit or a
+* cancellation request, and the next call carries on exactly where it stopped. After a solution, the next call goes
+* on to look for another one, so the solutions of a puzzle can be enumerated one at a time. Between calls, split() can
+* hand part of the remaining search over to another engine, which is how parallelSolve spreads one puzzle over threads.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "board.h"
+#include "search.h"
+
+enum class SearchStatus
+{
+    Solved,         // A solution was found. Running again looks for the next one.
+    Exhausted,      // There are no more solutions
+    OutOfBudget,    // The node budget or the time limit ran out. Running again continues.
+    Cancelled       // The cancel flag was set. Running again continues.
+};
+
+// Bounds on one call to SearchEngine::run. Zero means no limit.
+struct SearchLimits
+{
+    long long maxNodes = 0;
+    std::chrono::nanoseconds maxTime{ 0 };
+
+    // Checked at every node. The search stops soon after another thread sets it.
+    const std::atomic<bool>* cancel = nullptr;
+};
+
+class SearchEngine
+{
+public:
+    // Starts a new search of the puzzle. Returns false if its givens already repeat a digit, in which case run()
+    // reports Exhausted.
+    bool load(int board_[9][9]);
+    bool load(const Board& board_);
+
+    // Searches until the next solution, the end of the search, or a limit
+    SearchStatus run(const SearchLimits& limits_ = SearchLimits());
+
+    // The board as it stands: the last solution after Solved, or the spaces filled in so far otherwise
+    void store(int board_[9][9]) const;
+    void store(Board& board_) const;
+
+    // Nodes visited since load(), over every call to run()
+    long long nodesVisited() const { return nodes; }
+
+    // Guesses on the current path, from 0 up to the number of empty spaces
+    int depth() const { return nChoices; }
+
+    // Solutions found since load()
+    long long nSolutions() const { return solutions; }
+
+    // Hands part of the search that is left to someone else: writes the board as it stood at the shallowest guess with
+    // digits still untried, with the next of them placed, and skips that digit here. Searching the board and carrying
+    // on here covers the same ground as carrying on here alone. Returns false if no guess has untried digits.
+    bool split(Board& board_);
+
+private:
+    typedef Grid::Traits<3> T;
+    typedef T::Mask Mask;
+
+    // A guess: the space, the digits not tried there yet, and the length of the trail before it was made
+    struct Choice
+    {
+        uint8_t index;
+        Mask untried;
+        uint8_t trailMark;
+    };
+
+    // What run() does next
+    enum class Step
+    {
+        Propagate,      // Fill in singles after the last placement, then pick the next space or back out
+        Advance,        // Try the next digit of the latest guess, backing out of guesses with none left
+        Done
+    };
+
+    SearchState state;
+
+    // Spaces filled in, in order, so they can be emptied back to any choice point
+    uint8_t trail[T::cells];
+    int trailSize = 0;
+
+    Choice choices[T::cells];
+    int nChoices = 0;
+
+    Step step = Step::Done;
+    long long nodes = 0;
+    long long solutions = 0;
+
+    // Places a digit and adds its space to the trail
+    void place(int index_, int n_);
+    void undoTo(int trailMark_);
+};
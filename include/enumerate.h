@@ -0,0 +1,113 @@
+#pragma once
+
+/**
+* Author: Ryley Robinson
+*
+* enumerate.h: Every solution of a puzzle, one at a time, and a compact file format to stream them to.
+*
+* enumerateSolutions walks the whole search of engine.h and hands each solution to a callback as soon as it is found, so
+* a puzzle with millions of solutions never holds more than one board. To count them without looking at them,
+* parallelCountSolutions walks the same search without ever writing a board out.
+*
+* Solution file layout (all numbers little-endian):
+* - A 64 byte header: magic, number of solutions, format version, record size, and the puzzle, two digits per byte
+*   like PuzzleRecord::solution, with 0 for the empty spaces.
+* - One record per solution, holding only the digits of the empty spaces of the puzzle, in order, two per byte with the
+*   first one in the low four bits. A puzzle with 60 empty spaces takes 30 bytes per solution.
+*
+* The number of solutions in the header is only written when the writer is closed. Readers go by the size of the file
+* instead, so a file cut short still reads back up to its last whole record.
+*/
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "board.h"
+#include "engine.h"
+
+struct SolutionFileHeader
+{
+    char magic[8];
+    uint64_t nSolutions;
+    uint16_t version;
+    uint16_t recordSize;
+    uint8_t puzzle[41];
+    uint8_t reserved[3];
+};
+
+static_assert(sizeof(SolutionFileHeader) == 64, "The solution file header must stay 64 bytes");
+
+// Calls visit_(const Board& solution) for every solution of the puzzle, in the order the search finds them, until
+// visit_ returns false or limit_ solutions have been visited (0 for no limit). Returns the number of solutions visited.
+template <typename Visit>
+long long enumerateSolutions(const Board& board_, Visit visit_, long long limit_ = 0)
+{
+    SearchEngine engine;
+    if (!engine.load(board_)) return 0;
+
+    Board solution;
+    long long nVisited = 0;
+    while ((limit_ <= 0 || nVisited < limit_) && engine.run() == SearchStatus::Solved)
+    {
+        engine.store(solution);
+        nVisited++;
+        if (!visit_(static_cast<const Board&>(solution))) break;
+    }
+
+    return nVisited;
+}
+
+// Writes a new solution file, one solution at a time. Records are gathered into blocks before they are written.
+class SolutionWriter
+{
+public:
+    // Creates the file for the solutions of puzzle_, replacing any that exists. Returns false if it can't be created.
+    bool open(const std::string& path_, const Board& puzzle_);
+
+    // Appends a solution of the puzzle the file was opened for
+    bool append(const Board& solution_);
+
+    // Writes what is left and the final header. Returns false if anything failed to write.
+    bool close();
+
+    uint64_t size() const { return nSolutions; }
+    int recordSize() const { return (nEmpty + 1) / 2; }
+
+private:
+    std::ofstream file;
+    Board puzzle;
+    uint8_t empty[81];
+    int nEmpty = 0;
+    uint64_t nSolutions = 0;
+
+    std::vector<char> block;
+    size_t blockUsed = 0;
+
+    bool writeBlock();
+};
+
+// Reads a solution file back in order
+class SolutionReader
+{
+public:
+    // Opens the file and checks its header. Returns false if it can't be opened or isn't a solution file.
+    bool open(const std::string& path_);
+
+    // The puzzle the solutions belong to
+    const Board& puzzle() const { return puzzleBoard; }
+
+    // Number of solutions in the file
+    uint64_t size() const { return nSolutions; }
+
+    // Reads the next solution. Returns false after the last one.
+    bool next(Board& solution_);
+
+private:
+    std::ifstream file;
+    Board puzzleBoard;
+    uint8_t empty[81];
+    int nEmpty = 0;
+    uint64_t nSolutions = 0;
+    uint64_t nRead = 0;
+};
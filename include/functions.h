@@ -1,30 +1,214 @@
-#pragma once
-
-/**
-* Author: Ryley Robinson
-* 
-* functions.h: Includes all function declarations that will be used in the program.
-*/
-
-// Randomizes the solved board, unassigns digits from the unsolved board
-bool createBoard(int nDigitsToRemove_, int seedBoard_[9][9], int solvedBoard_[9][9], int unsolvedBoard_[9][9]);
-
-// Contains all of the algorithms to solve the sudoku
-void solveBoard(int board_[9][9]);
-
-// Uses a backtracking algorithm to brute-force solve the sudoku. Returns true if solved.
-bool recursiveSolve(int board_[9][9]);
-
-// Checks to make sure that the solution is valid
-bool checkSolution(int solvedBoard_[9][9], int unsolvedBoard_[9][9]);
-
-// Returns false if there's repeat digits in a row/column/square.
-bool sanityCheck(int board_[9][9]);
-
-// Prints the board in a nice format to the console
-void printBoard(int board_[9][9]);
-
-// Only prints the first possibility for each number in the working board
-void printBoard(std::vector<int> board_[9][9]);
-
-bool runAgainCheck();
+#pragma once
+
+/**
+* Author: Ryley Robinson
+* 
+* functions.h: Includes all function declarations that will be used in the program.
+*/
+
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include "board.h"
+#include "candidates.h"
+#include "engine.h"
+#include "search.h"
+#include "rng.h"
+#include "batch.h"
+#include "stream.h"
+#include "generate.h"
+#include "grade.h"
+
+// Exact solvers that can be selected at runtime. They explore the same solutions, so they must always agree.
+enum class SolverBackend
+{
+    Search,
+    Dlx
+};
+
+// Everything that can solve a puzzle: the human methods (with the search as a fallback), one of the exact backends,
+// the SIMD batch solver, which works through puzzles 16 at a time, the iterative search of engine.h, or the same search
+// spread over every core.
+enum class SolveEngine
+{
+    Human,
+    Search,
+    Dlx,
+    Batch,
+    Iterative,
+    Parallel
+};
+
+// Randomizes the solved board, unassigns digits from the unsolved board
+bool createBoard(int nDigitsToRemove_, int seedBoard_[9][9], int solvedBoard_[9][9], int unsolvedBoard_[9][9], SolverBackend backend_ = SolverBackend::Search);
+
+// Same as above, but draws every random choice from rng_ and touches nothing else, so it can run on many threads at once.
+bool createBoard(int nDigitsToRemove_, int seedBoard_[9][9], int solvedBoard_[9][9], int unsolvedBoard_[9][9], Rng& rng_, SolverBackend backend_ = SolverBackend::Search);
+
+// Same as above for a board of any box size: 9 x 9 for Box = 3, 16 x 16 for Box = 4 and 25 x 25 for Box = 5.
+// backend_ only applies to 9 x 9 boards, larger ones are always checked by the search.
+template <int Box>
+bool createGrid(int nDigitsToRemove_, int seedBoard_[Box * Box][Box * Box], int solvedBoard_[Box * Box][Box * Box], int unsolvedBoard_[Box * Box][Box * Box], Rng& rng_, SolverBackend backend_ = SolverBackend::Search);
+
+// createBoard for the compact Board type
+bool createBoard(int nDigitsToRemove_, const Board& seedBoard_, Board& solvedBoard_, Board& unsolvedBoard_, SolverBackend backend_ = SolverBackend::Search);
+bool createBoard(int nDigitsToRemove_, const Board& seedBoard_, Board& solvedBoard_, Board& unsolvedBoard_, Rng& rng_, SolverBackend backend_ = SolverBackend::Search);
+
+// Randomizes the solved board, and removes digits from the unsolved board until nClues_ remain, or until no more can be
+// removed if nClues_ is 0 (a minimal puzzle). Instead of starting over when it gets stuck, it puts back recently removed
+// digits and tries others. report_ (optional) receives the effort it took. Returns false if the target was never reached.
+template <int Box>
+bool generateGrid(int nClues_, int seedBoard_[Box * Box][Box * Box], int solvedBoard_[Box * Box][Box * Box], int unsolvedBoard_[Box * Box][Box * Box], Rng& rng_, GenerateReport* report_ = nullptr);
+
+// Same as generateGrid, but keeps removing digits until gradeBoard scores the board from minScore_ to maxScore_.
+// grade_ (optional) receives the grade of the finished board. Returns false if no such board was found.
+bool generateForDifficulty(int minScore_, int maxScore_, int seedBoard_[9][9], int solvedBoard_[9][9], int unsolvedBoard_[9][9], Rng& rng_, GenerateReport* report_ = nullptr, GradeReport* grade_ = nullptr);
+
+// Fills the board with a simple valid solution, to be used as a seed board for createGrid
+template <int Box>
+void patternGrid(int board_[Box * Box][Box * Box]);
+
+// Creates nPuzzles_ boards spread over nThreads_ worker threads (0 uses every core). Board i is written to puzzles_[i].
+// Each board draws from its own generator derived from seed_ and i, so the output doesn't depend on how work was scheduled.
+// If seen_ is given, boards equivalent to one in seen_ or earlier in the batch are created again, and the canonical
+// forms of the new boards are added to seen_. A board that is still equivalent to an earlier one after 64 tries is
+// dropped, and the boards after it move up. Returns the number of boards written, nPuzzles_ unless some were dropped.
+int generateBatch(int nPuzzles_, int nDigitsToRemove_, int seedBoard_[9][9], GeneratedPuzzle* puzzles_, uint64_t seed_, int nThreads_ = 0, SolverBackend backend_ = SolverBackend::Search, CanonicalSet* seen_ = nullptr);
+
+// Writes the canonical form of a well-posed puzzle and its solution: the same board for every puzzle equivalent to it
+// under reordering bands, stacks, rows within a band and columns within a stack, transposing and relabelling digits.
+void canonicalBoard(int unsolvedBoard_[9][9], int solvedBoard_[9][9], int canonicalUnsolved_[9][9], int canonicalSolved_[9][9] = nullptr);
+
+// The canonical form of the puzzle, packed for hashing
+CanonicalKey canonicalKey(int unsolvedBoard_[9][9], int solvedBoard_[9][9]);
+
+// Contains all of the algorithms to solve the sudoku
+void solveBoard(int board_[9][9]);
+void solveBoard(Board& board_);
+
+/*
+* The human methods used by solveBoard, one step each. They can also be run on their own.
+* Each returns how much progress it made: digits placed, or possible digits removed.
+*/
+
+// Writes every space of workingBoard_ with a single possible digit to board_, and marks that digit as used.
+int placeSingles(CandidateBoard& workingBoard_, int board_[9][9]);
+
+// Removes possible digits that are already used in the same row, column, or square.
+int removeRuledOut(CandidateBoard& workingBoard_);
+
+// Reduces a space to a digit that is possible nowhere else in one of its rows, columns, or squares.
+int findHiddenSingles(CandidateBoard& workingBoard_);
+
+// Removes the digits of a naked pair from the rest of the row, column, or square.
+int findNakedPairs(CandidateBoard& workingBoard_);
+
+// Reduces the two spaces of a hidden pair (two digits possible in only the same two spaces of a unit) to those digits.
+int findHiddenPairs(CandidateBoard& workingBoard_);
+
+// Removes a digit from the rest of a row or column when the only places for it in a square are on that line.
+int findPointingPairs(CandidateBoard& workingBoard_);
+
+// Removes a digit from the rest of a square when the only places for it in a row or column are in that square.
+int findBoxLineReductions(CandidateBoard& workingBoard_);
+
+// Removes a digit from two columns when two rows can only hold it in those columns, or the same with rows and columns swapped.
+int findXWings(CandidateBoard& workingBoard_);
+
+// Same as findXWings, with three rows and three columns.
+int findSwordfish(CandidateBoard& workingBoard_);
+
+// The human methods in the order solveBoard tries them, easiest first
+extern const Technique humanTechniques[];
+extern const int nHumanTechniques;
+
+// Runs the techniques on the board until none of them makes progress, filling in every space it can. report_ (optional)
+// receives which techniques were used and the difficulty score. Stops early once the score goes past maxScore_.
+// Returns true if the board was completely solved.
+bool applyTechniques(int board_[9][9], GradeReport* report_ = nullptr, int maxScore_ = INT_MAX, const Technique* techniques_ = humanTechniques, int nTechniques_ = nHumanTechniques);
+
+// Grades the puzzle by the human methods it takes, without modifying it. Returns the difficulty score.
+int gradeBoard(int board_[9][9], GradeReport* report_ = nullptr, int maxScore_ = INT_MAX);
+
+// Uses a backtracking algorithm to brute-force solve the sudoku. Returns true if solved.
+bool recursiveSolve(int board_[9][9], SearchStats* stats_ = nullptr);
+bool recursiveSolve(Board& board_, SearchStats* stats_ = nullptr);
+
+// Uses constraint propagation and a backtracking search on the most constrained space to solve the sudoku. Returns true if solved.
+bool searchSolve(int board_[9][9], SearchStats* stats_ = nullptr);
+
+// Counts the solutions of the sudoku with a single search, stopping once limit_ have been found. Does not modify the board.
+int countSolutions(int board_[9][9], int limit_, SearchStats* stats_ = nullptr);
+
+// Same as searchSolve, with the search split between nThreads_ threads (0 uses every core) as it goes, for single puzzles
+// too hard for one core. Puzzles solved within the first few thousand nodes never start a thread. If the puzzle has more
+// than one solution, the one found depends on how the threads were scheduled.
+bool parallelSolve(int board_[9][9], int nThreads_ = 0, SearchStats* stats_ = nullptr);
+
+// Same as countSolutions, on nThreads_ threads. A limit_ of 0 counts every solution.
+long long parallelCountSolutions(int board_[9][9], long long limit_, int nThreads_ = 0, SearchStats* stats_ = nullptr);
+
+// searchSolve and countSolutions for a board of any box size
+template <int Box>
+bool solveGrid(int board_[Box * Box][Box * Box], SearchStats* stats_ = nullptr);
+
+template <int Box>
+int countGridSolutions(int board_[Box * Box][Box * Box], int limit_, SearchStats* stats_ = nullptr);
+
+// Uses dancing links over the exact cover form of the sudoku to solve it. Returns true if solved.
+bool dlxSolve(int board_[9][9], SearchStats* stats_ = nullptr);
+
+// Same as countSolutions, using dancing links.
+int dlxCountSolutions(int board_[9][9], int limit_, SearchStats* stats_ = nullptr);
+
+// Solves nBoards_ boards in place, running candidate elimination on up to 16 of them at once in SIMD lanes.
+// Boards the elimination can't finish are handed to searchSolve. solved_ (optional) receives the outcome of each board. Returns how many were solved.
+int batchSolve(int (*boards_)[9][9], int nBoards_, bool* solved_ = nullptr);
+
+// Name of the instruction set batchSolve picked for this CPU: "avx2", "sse2" or "scalar"
+const char* batchSolveIsa();
+
+// Solves the sudoku with the selected backend. Returns true if solved.
+bool exactSolve(int board_[9][9], SolverBackend backend_, SearchStats* stats_ = nullptr);
+
+// Counts solutions with the selected backend, stopping once limit_ have been found.
+int exactCountSolutions(int board_[9][9], int limit_, SolverBackend backend_, SearchStats* stats_ = nullptr);
+
+// Runs both backends over a corpus of known and randomly derived puzzles. Returns the number of puzzles they disagree on.
+int compareBackends(int nPuzzles_, int seedBoard_[9][9]);
+
+// Solves every puzzle in in_ (one line each: 81 characters, or 256 or 625 for 16 x 16 and 25 x 25 boards) with the selected engine, and writes one solution line per puzzle to out_.
+StreamReport solveStream(std::istream& in_, std::ostream& out_, SolveEngine engine_);
+
+// Grades every 9 x 9 puzzle in in_ with gradeBoard, and writes each one to out_ followed by its score and the hardest
+// technique it needed ("singles" if none, "search" if the techniques got stuck). nSolved counts puzzles the techniques solved.
+StreamReport gradeStream(std::istream& in_, std::ostream& out_);
+
+// Counts the solutions of every 9 x 9 puzzle in in_ with parallelCountSolutions, up to limit_ each (0 for no limit), and
+// writes each one to out_ followed by its count. nSolved counts puzzles with exactly one solution.
+StreamReport countStream(std::istream& in_, std::ostream& out_, long long limit_ = 0);
+
+// Checks to make sure that the solution is valid
+bool checkSolution(int solvedBoard_[9][9], int unsolvedBoard_[9][9]);
+bool checkSolution(const Board& solvedBoard_, const Board& unsolvedBoard_);
+
+// Returns false if there's repeat digits in a row/column/square, or a space holding anything past 9.
+bool sanityCheck(int board_[9][9]);
+bool sanityCheck(const Board& board_);
+
+// Runs sanityCheck on nBoards_ boards, checking up to 16 of them at once in SIMD lanes like batchSolve.
+// valid_ (optional) receives the result for each board. Returns how many passed.
+int sanityCheckBatch(const Board* boards_, int nBoards_, bool* valid_ = nullptr);
+
+// Prints the board in a nice format to the console
+void printBoard(int board_[9][9], std::ostream& out_ = std::cout);
+void printBoard(const Board& board_, std::ostream& out_ = std::cout);
+
+// Same as above for a board of any box size. Digits above 9 are written as letters.
+template <int Box>
+void printGrid(int board_[Box * Box][Box * Box], std::ostream& out_ = std::cout);
+
+// Prints every possibility for each space in the working board
+void printBoard(const CandidateBoard& board_, std::ostream& out_ = std::cout);
+
+bool runAgainCheck();
@@ -0,0 +1,27 @@
+#pragma once
+
+/**
+* Author: Ryley Robinson
+*
+* generate.h: Summary of generating one puzzle with a target number of clues.
+*/
+
+struct GenerateReport
+{
+    // Clues left on the finished puzzle
+    int nClues = 0;
+
+    // Removals tried, each one checked for a second solution
+    long long nAttempts = 0;
+
+    // Times the removals got stuck above the target and some of them were undone
+    long long nBacktracks = 0;
+
+    // Times a new solved board had to be drawn
+    long long nRestarts = 0;
+
+    // Boards graded on the way, when generating for a difficulty
+    long long nGraded = 0;
+
+    double seconds = 0;
+};
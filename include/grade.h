@@ -0,0 +1,44 @@
+#pragma once
+
+/**
+* Author: Ryley Robinson
+*
+* grade.h: The human methods as a pipeline of techniques, and the difficulty report it produces.
+*/
+
+#include "candidates.h"
+
+// One human method. Techniques are tried in order, and each round starts over from the first one.
+struct Technique
+{
+    const char* name;
+
+    // Added to the difficulty score every round this technique makes progress
+    int weight;
+
+    // Returns how much progress was made: possible digits removed
+    int (*apply)(CandidateBoard& workingBoard_);
+};
+
+// Score added when the techniques get stuck and the rest of the board has to be guessed by the search
+const int searchWeight = 100;
+
+struct GradeReport
+{
+    static constexpr int maxTechniques = 16;
+
+    // Rounds each technique made progress in, in pipeline order
+    int nUses[maxTechniques] = {};
+
+    // Sum of the weights of every round, plus searchWeight if the techniques got stuck
+    int score = 0;
+
+    // Index of the hardest technique that made progress, or -1 if placing singles was enough
+    int hardest = -1;
+
+    // Whether the techniques solved the board on their own
+    bool solved = false;
+
+    // Whether grading stopped early because the score went past the limit
+    bool aborted = false;
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+/**
+* Author: Ryley Robinson
+*
+* grid.h: Sizes, possibility masks and unit lookup tables for boards of any box size.
+*
+* A board with Box x Box squares has Box * Box digits, rows and columns: 9 x 9 for Box = 3, 16 x 16 for Box = 4
+* and 25 x 25 for Box = 5. Everything here is picked at compile time, so a 9 x 9 board still uses 16-bit masks
+* and byte-sized space indices.
+*/
+
+#include <cstdint>
+#include <type_traits>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Grid
+{
+    template <int Box>
+    struct Traits
+    {
+        static constexpr int box = Box;
+        static constexpr int size = Box * Box;
+        static constexpr int cells = size * size;
+        static constexpr int units = 3 * size;
+        static constexpr int peers = 2 * (size - 1) + (Box - 1) * (Box - 1);
+
+        // Bit (n - 1) is set when digit n is possible
+        typedef typename std::conditional<(size <= 16), uint16_t,
+            typename std::conditional<(size <= 32), uint32_t, uint64_t>::type>::type Mask;
+
+        // Index of a space on the board
+        typedef typename std::conditional<(cells <= 256), uint8_t, uint16_t>::type Index;
+
+        static constexpr Mask allDigits = static_cast<Mask>((static_cast<uint64_t>(1) << size) - 1);
+    };
+
+    // Number of possible digits in a mask
+    template <typename Mask>
+    inline int countDigits(Mask mask_)
+    {
+#if defined(_MSC_VER)
+        return static_cast<int>(__popcnt64(static_cast<uint64_t>(mask_)));
+#else
+        if (sizeof(Mask) <= sizeof(unsigned int)) return __builtin_popcount(static_cast<unsigned int>(mask_));
+        return __builtin_popcountll(static_cast<unsigned long long>(mask_));
+#endif
+    }
+
+    // Lowest possible digit in a non-empty mask
+    template <typename Mask>
+    inline int firstDigit(Mask mask_)
+    {
+#if defined(_MSC_VER)
+        unsigned long bit;
+        _BitScanForward64(&bit, static_cast<uint64_t>(mask_));
+        return static_cast<int>(bit) + 1;
+#else
+        if (sizeof(Mask) <= sizeof(unsigned int)) return __builtin_ctz(static_cast<unsigned int>(mask_)) + 1;
+        return __builtin_ctzll(static_cast<unsigned long long>(mask_)) + 1;
+#endif
+    }
+
+    template <typename Mask>
+    inline Mask digitMask(int n_)
+    {
+        return static_cast<Mask>(static_cast<Mask>(1) << (n_ - 1));
+    }
+
+    /*
+    * Lookup tables for the units of the board.
+    * Units 0 to size - 1 are rows, then come the columns and then the squares.
+    * Each space also has peers: the other spaces sharing a row, column or square with it.
+    */
+    template <int Box>
+    struct UnitTables
+    {
+        typedef Traits<Box> T;
+        typedef typename T::Index Index;
+
+        Index unitCells[T::units][T::size];
+        uint8_t cellUnits[T::cells][3];
+        Index peers[T::cells][T::peers];
+    };
+
+    template <int Box>
+    constexpr UnitTables<Box> makeUnitTables()
+    {
+        typedef Traits<Box> T;
+        typedef typename T::Index Index;
+        UnitTables<Box> tables = {};
+
+        for (int i = 0; i < T::size; i++)
+        {
+            for (int j = 0; j < T::size; j++)
+            {
+                tables.unitCells[i][j] = static_cast<Index>(T::size * i + j);
+                tables.unitCells[T::size + i][j] = static_cast<Index>(T::size * j + i);
+                tables.unitCells[2 * T::size + i][j] = static_cast<Index>(T::size * (Box * (i / Box) + j / Box) + Box * (i % Box) + j % Box);
+            }
+        }
+
+        for (int i = 0; i < T::cells; i++)
+        {
+            int row = i / T::size, col = i % T::size;
+            int square = Box * (row / Box) + col / Box;
+            tables.cellUnits[i][0] = static_cast<uint8_t>(row);
+            tables.cellUnits[i][1] = static_cast<uint8_t>(T::size + col);
+            tables.cellUnits[i][2] = static_cast<uint8_t>(2 * T::size + square);
+
+            // Row and column first, then the rest of the square
+            int nPeers = 0;
+            for (int j = 0; j < T::size; j++)
+            {
+                if (j != col) tables.peers[i][nPeers++] = static_cast<Index>(T::size * row + j);
+                if (j != row) tables.peers[i][nPeers++] = static_cast<Index>(T::size * j + col);
+            }
+            for (int j = 0; j < T::size; j++)
+            {
+                int peer = tables.unitCells[2 * T::size + square][j];
+                if (peer / T::size != row && peer % T::size != col) tables.peers[i][nPeers++] = static_cast<Index>(peer);
+            }
+        }
+
+        return tables;
+    }
+
+    template <int Box>
+    inline constexpr UnitTables<Box> units = makeUnitTables<Box>();
+
+    template <int Box>
+    inline int squareOf(int row_, int col_)
+    {
+        return Box * (row_ / Box) + col_ / Box;
+    }
+
+    // Characters used to read and write digits: 1-9, then letters for boards with more than nine digits
+    const char digitChars[] = "0123456789ABCDEFGHIJKLMNOP";
+
+    // Digit for a character, 0 for an empty space ('0' or '.'), or -1 if it isn't a digit on a board with size_ digits
+    inline int charToDigit(char c_, int size_)
+    {
+        if (c_ == '.' || c_ == '0') return 0;
+
+        int n = -1;
+        if (c_ >= '1' && c_ <= '9') n = c_ - '0';
+        else if (c_ >= 'A' && c_ <= 'P') n = c_ - 'A' + 10;
+        else if (c_ >= 'a' && c_ <= 'p') n = c_ - 'a' + 10;
+
+        return n >= 1 && n <= size_ ? n : -1;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+/**
+* Author: Ryley Robinson
+*
+* rng.h: Small random number generator with explicit state (splitmix64).
+* Unlike rand(), each caller owns its own state, so any number of threads can generate boards at once.
+*/
+
+#include <cstdint>
+
+struct Rng
+{
+    uint64_t state;
+
+    explicit Rng(uint64_t seed_ = 0) : state(seed_) {}
+
+    // Independent generator for one of many streams sharing a seed, such as one per puzzle in a batch
+    static Rng stream(uint64_t seed_, uint64_t index_)
+    {
+        Rng mixer(seed_ ^ (index_ * 0xD1B54A32D192ED03ull));
+        return Rng(mixer.next());
+    }
+
+    uint64_t next()
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Returns a number in [0, n_)
+    int below(int n_)
+    {
+        return static_cast<int>(((next() >> 32) * static_cast<uint64_t>(n_)) >> 32);
+    }
+};
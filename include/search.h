@@ -0,0 +1,172 @@
+#pragma once
+
+/**
+* Author: Ryley Robinson
+*
+* search.h: State used by the constraint-propagating backtracking search.
+*/
+
+#include <bitset>
+#include <cstdint>
+#include "grid.h"
+
+// Counters reported by the backtracking solvers, so that they can be compared with each other
+struct SearchStats
+{
+    long long nodesVisited = 0;
+};
+
+/*
+* Board state carried through the search.
+* Row, column and square occupancy masks are updated as each digit is placed, so the possible digits of
+* any space are a single AND-NOT away. The state is small enough to be copied at each branch instead of undone.
+*/
+template <int Box>
+struct BasicSearchState
+{
+    typedef Grid::Traits<Box> T;
+    typedef typename T::Mask Mask;
+
+    uint8_t digits[T::cells];
+    Mask rowUsed[T::size];
+    Mask colUsed[T::size];
+    Mask squUsed[T::size];
+    int nEmpty;
+
+    // Copies the known digits of board_. Returns false if they already repeat in a row/column/square.
+    bool load(int board_[T::size][T::size]);
+
+    // Writes the placed digits back to board_
+    void store(int board_[T::size][T::size]) const;
+
+    // Places digit n_ in a space and marks it used in that space's row, column and square
+    void place(int index_, int n_);
+
+    // Empties a space placed earlier, and frees its digit in that space's row, column and square
+    void remove(int index_);
+
+    // Fills in naked and hidden singles until none remain. Returns false if a contradiction is found.
+    bool propagate();
+
+    // The same, calling placed_(index) after each space it fills in, so a caller that undoes its placements
+    // (SearchEngine) can record them
+    template <typename Placed>
+    bool propagate(Placed placed_);
+
+    // Returns the empty space with the fewest possible digits, or -1 if the board is full
+    int pickSpace() const;
+
+    Mask possible(int index_) const
+    {
+        int row = index_ / T::size, col = index_ % T::size;
+        return T::allDigits & ~(rowUsed[row] | colUsed[col] | squUsed[Grid::squareOf<Box>(row, col)]);
+    }
+};
+
+template <int Box>
+template <typename Placed>
+bool BasicSearchState<Box>::propagate(Placed placed_)
+{
+    bool progress = true;
+
+    while (progress && nEmpty > 0)
+    {
+        progress = false;
+
+        // Naked singles
+        for (int i = 0; i < T::cells; i++)
+        {
+            if (digits[i] != 0) continue;
+
+            Mask mask = possible(i);
+            if (mask == 0) return false;
+
+            if (Grid::countDigits(mask) == 1)
+            {
+                place(i, Grid::firstDigit(mask));
+                placed_(i);
+                progress = true;
+            }
+        }
+
+        // Hidden singles
+        for (int unit = 0; unit < T::units; unit++)
+        {
+            const typename T::Index* cells = Grid::units<Box>.unitCells[unit];
+            Mask once = 0, twice = 0, solved = 0;
+
+            for (int j = 0; j < T::size; j++)
+            {
+                if (digits[cells[j]] != 0)
+                {
+                    solved |= Grid::digitMask<Mask>(digits[cells[j]]);
+                    continue;
+                }
+
+                Mask mask = possible(cells[j]);
+                twice |= once & mask;
+                once |= mask;
+            }
+
+            // A digit that is neither placed nor possible anywhere in the unit
+            if ((once | solved) != T::allDigits) return false;
+
+            Mask hidden = once & ~twice;
+            while (hidden != 0)
+            {
+                Mask bit = hidden & (~hidden + 1);
+                hidden &= hidden - 1;
+
+                int j = 0;
+                while (j < T::size && (digits[cells[j]] != 0 || (possible(cells[j]) & bit) == 0)) j++;
+
+                // An earlier placement took this digit's only space
+                if (j == T::size) return false;
+
+                place(cells[j], Grid::firstDigit(bit));
+                placed_(cells[j]);
+                progress = true;
+            }
+        }
+    }
+
+    return true;
+}
+
+typedef BasicSearchState<3> SearchState;
+
+/*
+* State kept by the generator while it removes digits from a solved board one at a time.
+* The givens stay loaded between removals, so removing one only clears its digit from three masks. A removal keeps
+* the puzzle well-posed exactly when no solution puts a different digit in that space, so the check is a search for
+* such a solution, starting from the givens, rather than a count of every solution from a freshly loaded board.
+*
+* Every second solution found along the way is remembered by the spaces where it differs from the first. As long as
+* one of those spaces keeps its given digit, that solution stays ruled out. A removal that would take away the last
+* one can be turned down straight away, without searching.
+*/
+template <int Box>
+struct BasicRemovalState
+{
+    typedef Grid::Traits<Box> T;
+
+    // Second solutions remembered per solved board. The oldest is forgotten first.
+    static constexpr int maxWitnesses = 256;
+
+    BasicSearchState<Box> givens;
+    BasicSearchState<Box> solved;
+    std::bitset<T::cells> givenSpaces;
+    std::bitset<T::cells> witnesses[maxWitnesses];
+    int nWitnesses;
+
+    // Starts from a complete, valid board. Returns false if it isn't one.
+    bool load(int solvedBoard_[T::size][T::size]);
+
+    // Removes the given digit at index_ if the puzzle stays well-posed without it. Returns true if it was removed.
+    bool tryRemove(int index_, SearchStats* stats_ = nullptr);
+
+    // Puts back digit n_, removed from index_ earlier
+    void restore(int index_, int n_);
+};
+
+typedef BasicRemovalState<3> RemovalState;
@@ -0,0 +1,60 @@
+#pragma once
+
+/**
+* Author: Ryley Robinson
+*
+* service.h: Long-running solver service. Requests are read one per line, queued, and handled by a fixed pool of
+* worker threads, each answering with one line.
+*
+* Requests: "<id> <command> [argument]", where id is any word without spaces and is echoed in the response.
+* - "<id> solve <puzzle>"   answers "<id> ok <solution>"
+* - "<id> grade <puzzle>"   answers "<id> ok <score> <hardest method>"
+* - "<id> generate [n]"     answers "<id> ok <puzzle> <solution>", with n digits removed (the default if omitted)
+* - "<id> stats [json]"     answers "<id> ok <statistics as one line of JSON>", if statistics are on (see stats.h)
+* - "<id> stats prometheus" answers "<id> ok <n>", followed by n lines in the Prometheus text format
+* Anything that can't be handled answers "<id> error <reason>". Puzzles use the 81 character format of --solve.
+*
+* Responses are written as soon as a worker finishes, so they can come back in a different order than the requests.
+* Clients that send many requests at once have to read responses as they go: a socket client that stops reading for
+* too long is disconnected.
+*/
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+struct ServiceOptions
+{
+    // Worker threads. 0 uses every core.
+    int nWorkers = 0;
+
+    // Requests waiting for a worker. Once the queue is full, reading stops until a worker takes one, so clients
+    // that send faster than the workers answer are slowed down instead of piling up memory.
+    size_t queueCapacity = 1024;
+
+    // Board that generated puzzles are derived from, and the digits removed when a request doesn't say
+    int (*seedBoard)[9] = nullptr;
+    int nDigitsToRemove = 55;
+
+    uint64_t seed = 0;
+
+    // Limits on each solve request, which answers with an error instead of running on. Zero means no limit.
+    long long solveNodeLimit = 0;
+    std::chrono::milliseconds solveTimeLimit{ 0 };
+};
+
+struct ServiceReport
+{
+    long long nRequests = 0;
+    long long nErrors = 0;
+    double seconds = 0;
+};
+
+// Serves requests from in_ until it ends, writing responses to out_. Returns once every request has been answered.
+ServiceReport serveStream(std::istream& in_, std::ostream& out_, const ServiceOptions& options_);
+
+// Listens on a Unix domain socket at path_, serving every connection with the same worker pool. Only returns if the
+// socket can't be set up (returning false), or isn't supported on this platform.
+bool serveSocket(const std::string& path_, const ServiceOptions& options_);
@@ -0,0 +1,148 @@
+#pragma once
+
+/**
+* Author: Ryley Robinson
+*
+* stats.h: Counters and phase timers for the generate and solve paths, collected while the program runs.
+*
+* Statistics are off until enable() is called, and every counter and timer is a single branch until then. Once on,
+* each thread counts into its own block, so the hot paths never take a lock or share a cache line. collect() sums the
+* blocks of every thread, including threads that have finished, and the result can be written as JSON or in the
+* Prometheus text format.
+*
+* Timers read the time stamp counter where there is one, and the steady clock otherwise. Every phase keeps a count,
+* the total and the longest time, and a histogram with power of two buckets, so a slow request can be traced back to
+* the phase it spent its time in.
+*/
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define SUDOKU_STATS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SUDOKU_STATS_TSC 1
+#else
+#include <chrono>
+#endif
+
+namespace Stats
+{
+    // Human methods timed on their own, in the order of humanTechniques. The phase of method t is technique(t).
+    constexpr int maxTechniques = 8;
+
+    // Power of two buckets of the phase histograms. Bucket b counts times from 2^(b-1) up to 2^b nanoseconds, and the
+    // last one everything longer.
+    constexpr int nBuckets = 32;
+
+    enum class Counter
+    {
+        BoardsCreated,      // createBoard calls that removed every digit asked for
+        CreateRetries,      // createBoard calls that ran out of digits to remove, and have to be made again
+        RemovalAttempts,    // Digits the generator tried to remove
+        RemovalsRejected,   // Removals put back because the board would have had more than one solution
+        BoardsSolved,       // solveBoard calls
+        SearchFallbacks,    // solveBoard calls the human methods couldn't finish
+        TechniqueRounds,    // Rounds of the human method pipeline
+        Requests,           // Requests answered by the service
+        RequestErrors,      // Requests the service answered with an error
+        Count
+    };
+
+    enum class Phase
+    {
+        CreateBoard,        // One whole createBoard call
+        Randomize,          // Transforming the seed board into a new solution
+        RemoveDigits,       // Removing digits, including every uniqueness check
+        UniquenessCheck,    // Checking a single removal
+        SolveBoard,         // One whole solveBoard call
+        Singles,            // Placing the spaces with a single possible digit, once per round
+        Technique,          // One human method, once per round it is tried. Kept per method, see technique().
+        Search = Technique + maxTechniques, // The backtracking search solveBoard falls back on
+        Request,            // One service request
+        Count
+    };
+
+    constexpr int nCounters = static_cast<int>(Counter::Count);
+    constexpr int nPhases = static_cast<int>(Phase::Count);
+
+    inline Phase technique(int t_) { return static_cast<Phase>(static_cast<int>(Phase::Technique) + t_); }
+
+    struct PhaseTotals
+    {
+        uint64_t count = 0;
+        uint64_t nanos = 0;
+        uint64_t maxNanos = 0;
+        uint64_t buckets[nBuckets] = {};
+    };
+
+    struct Snapshot
+    {
+        uint64_t counters[nCounters] = {};
+        PhaseTotals phases[nPhases];
+    };
+
+    // Starts collecting. Also measures the rate of the time stamp counter, which takes a couple of milliseconds.
+    void enable();
+
+    bool enabled();
+
+    // Sums the counts of every thread so far
+    Snapshot collect();
+
+    // Names used in both output formats, such as "removal_attempts" or "uniqueness_check"
+    const char* counterName(Counter counter_);
+    const char* phaseName(Phase phase_);
+
+    // Writes a snapshot as one line of JSON, with times in seconds
+    void writeJson(const Snapshot& snapshot_, std::ostream& out_);
+
+    // Writes a snapshot in the Prometheus text exposition format, with every metric prefixed by "sudoku_"
+    void writePrometheus(const Snapshot& snapshot_, std::ostream& out_);
+
+    // Used by the inline functions below
+    namespace Detail
+    {
+        extern std::atomic<bool> on;
+
+        inline uint64_t ticks()
+        {
+#if defined(SUDOKU_STATS_TSC)
+            return __rdtsc();
+#else
+            return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+        }
+
+        void add(Counter counter_, uint64_t n_);
+        void record(Phase phase_, uint64_t ticks_);
+    }
+
+    inline void count(Counter counter_, uint64_t n_ = 1)
+    {
+        if (Detail::on.load(std::memory_order_relaxed)) Detail::add(counter_, n_);
+    }
+
+    // Times the phase it is created for, from its construction to the end of its scope. Does nothing if active_ is false.
+    class Timer
+    {
+    public:
+        explicit Timer(Phase phase_, bool active_ = true) :
+            phase(phase_), start(active_ && Detail::on.load(std::memory_order_relaxed) ? Detail::ticks() : 0) {}
+
+        ~Timer()
+        {
+            if (start != 0) Detail::record(phase, Detail::ticks() - start);
+        }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+    private:
+        Phase phase;
+        uint64_t start;
+    };
+}
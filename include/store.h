@@ -0,0 +1,99 @@
+#pragma once
+
+/**
+* Author: Ryley Robinson
+*
+* store.h: On-disk puzzle database. Puzzles are written once with PuzzleStoreWriter, and read back by mapping the file.
+*
+* File layout (all numbers little-endian):
+* - A 64 byte header: magic, format version, record size, number of records and the offset of the first record.
+* - One 64 byte record per puzzle, so record i is found at a fixed offset without reading anything else.
+*
+* Records are read in place from the mapped file, so opening a store costs the same for ten puzzles as for ten million.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// One puzzle, its solution and its grade
+struct PuzzleRecord
+{
+    // The solution, two digits per byte, the first one in the low four bits
+    uint8_t solution[41];
+
+    // Bit i % 8 of byte i / 8 is set if space i is given in the puzzle
+    uint8_t clues[11];
+
+    // Difficulty score from gradeBoard
+    uint16_t score;
+
+    uint8_t nClues;
+    uint8_t reserved[9];
+
+    void pack(int unsolvedBoard_[9][9], int solvedBoard_[9][9], int score_);
+    void unpack(int unsolvedBoard_[9][9], int solvedBoard_[9][9]) const;
+};
+
+static_assert(sizeof(PuzzleRecord) == 64, "Puzzle records must stay 64 bytes, the record size of the file format");
+
+struct PuzzleStoreHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t nRecords;
+    uint64_t recordsOffset;
+    uint8_t reserved[32];
+};
+
+static_assert(sizeof(PuzzleStoreHeader) == 64, "The store header must stay 64 bytes");
+
+// Read-only view of a store file
+class PuzzleStore
+{
+public:
+    PuzzleStore() = default;
+    ~PuzzleStore();
+
+    PuzzleStore(const PuzzleStore&) = delete;
+    PuzzleStore& operator=(const PuzzleStore&) = delete;
+
+    // Maps the file and checks its header. Returns false if it can't be opened or isn't a store.
+    bool open(const std::string& path_);
+
+    void close();
+
+    size_t size() const { return nRecords; }
+
+    // Record i_, read in place. i_ must be less than size().
+    const PuzzleRecord& record(size_t i_) const { return records[i_]; }
+
+private:
+    const PuzzleRecord* records = nullptr;
+    size_t nRecords = 0;
+
+    // The whole mapped file, or the buffer it was read into where files can't be mapped
+    const void* mapping = nullptr;
+    size_t mappingSize = 0;
+    std::vector<uint64_t> buffer;
+};
+
+// Writes a new store file, one puzzle at a time
+class PuzzleStoreWriter
+{
+public:
+    // Creates the file, replacing any that exists. Returns false if it can't be created.
+    bool open(const std::string& path_);
+
+    bool append(int unsolvedBoard_[9][9], int solvedBoard_[9][9], int score_);
+
+    // Writes the final header. Returns false if anything failed to write.
+    bool close();
+
+private:
+    std::ofstream file;
+    uint64_t nRecords = 0;
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+/**
+* Author: Ryley Robinson
+*
+* stream.h: Summary of a headless batch solve over a stream of puzzles.
+*/
+
+struct StreamReport
+{
+    long long nPuzzles = 0;
+    long long nSolved = 0;
+
+    // Lines that weren't an 81 character puzzle
+    long long nMalformed = 0;
+
+    double seconds = 0;
+    double p50Micros = 0;
+    double p99Micros = 0;
+};
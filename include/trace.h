@@ -0,0 +1,70 @@
+#pragma once
+
+/**
+* Author: Ryley Robinson
+*
+* trace.h: Debug tracing for the generate and solve paths.
+*
+* Tracing is only compiled in when SUDOKU_TRACE is defined (configure with -DSUDOKU_TRACE=ON).
+* Otherwise every TRACE statement sits behind an `if constexpr` on a false constant, so it is still
+* type-checked but generates no code, and generating or solving a board does no I/O at all.
+*/
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+namespace Trace
+{
+#if defined(SUDOKU_TRACE)
+    constexpr bool enabled = true;
+#else
+    constexpr bool enabled = false;
+#endif
+
+    // Sends trace lines to stderr. This is the default.
+    void toConsole();
+
+    // Appends trace lines to a file. Returns false if it can't be opened.
+    bool toFile(const std::string& path_);
+
+    // Keeps only the last capacity_ trace lines in memory, to be written out later by dumpRing
+    void toRing(size_t capacity_);
+
+    // Writes the lines held by the ring buffer, oldest first
+    void dumpRing(std::ostream& out_);
+
+    // Records one finished trace line in the current sink
+    void write(const std::string& line_);
+
+    // Collects one trace line, and records it when it goes out of scope
+    class Line
+    {
+    public:
+        ~Line() { write(buffer.str()); }
+
+        std::ostream& stream() { return buffer; }
+
+        template <typename T>
+        Line& operator<<(const T& value_)
+        {
+            buffer << value_;
+            return *this;
+        }
+
+    private:
+        std::ostringstream buffer;
+    };
+}
+
+// Traces one line built from a stream expression, e.g. TRACE("Removing digit " << n);
+#define TRACE(message_) \
+    do { if constexpr (Trace::enabled) { Trace::Line() << message_; } } while (false)
+
+// Traces a board, or a working board, in the same format as printBoard
+#define TRACE_BOARD(board_) \
+    do { if constexpr (Trace::enabled) { Trace::Line traceLine; printBoard(board_, traceLine.stream()); } } while (false)
+
+// Same as TRACE_BOARD for a board of any box size, in the same format as printGrid
+#define TRACE_GRID(Box_, board_) \
+    do { if constexpr (Trace::enabled) { Trace::Line traceLine; printGrid<Box_>(board_, traceLine.stream()); } } while (false)
@@ -0,0 +1,187 @@
+/**
+* Author: Ryley Robinson
+*
+* batch.cpp: Multithreaded batch board generation. Declared in functions.h.
+*
+* Work distribution:
+* - The requested boards are split into one contiguous range of indices per thread.
+* - Each thread creates boards from the front of its own range.
+* - A thread whose range is empty steals the back half of the largest range left, so threads that draw
+*   slow boards (many retries) don't hold up the rest of the batch.
+*
+* Skipping equivalent boards:
+* - Each thread also works out the canonical form of the boards it creates.
+* - Once all of them are done, the canonical forms go into the set in index order, and every board whose form is
+*   already there is created again from a fresh stream. This repeats until no board is left over, so the output
+*   still only depends on the seed. A board that keeps coming out equivalent is eventually dropped.
+*/
+
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "functions.h"
+#include "trace.h"
+
+namespace
+{
+    // Indices [next, end) still to be generated by one thread
+    struct WorkRange
+    {
+        std::mutex lock;
+        int next = 0;
+        int end = 0;
+    };
+
+    // Takes the next index from the front of a thread's own range. Returns -1 if it is empty.
+    int takeOwn(WorkRange& range_)
+    {
+        std::lock_guard<std::mutex> guard(range_.lock);
+        return range_.next < range_.end ? range_.next++ : -1;
+    }
+
+    // Moves the back half of the largest other range into own_. Returns false if there is nothing left to steal.
+    bool steal(std::vector<WorkRange>& ranges_, int own_)
+    {
+        while (true)
+        {
+            int victim = -1, victimSize = 0;
+            for (int t = 0; t < static_cast<int>(ranges_.size()); t++)
+            {
+                std::lock_guard<std::mutex> guard(ranges_[t].lock);
+                if (t != own_ && ranges_[t].end - ranges_[t].next > victimSize)
+                {
+                    victim = t;
+                    victimSize = ranges_[t].end - ranges_[t].next;
+                }
+            }
+
+            if (victim < 0) return false;
+
+            int begin, end;
+            {
+                std::lock_guard<std::mutex> guard(ranges_[victim].lock);
+                int size = ranges_[victim].end - ranges_[victim].next;
+
+                // Someone else got there first
+                if (size <= 0) continue;
+
+                end = ranges_[victim].end;
+                begin = end - (size + 1) / 2;
+                ranges_[victim].end = begin;
+            }
+
+            std::lock_guard<std::mutex> guard(ranges_[own_].lock);
+            ranges_[own_].next = begin;
+            ranges_[own_].end = end;
+            return true;
+        }
+    }
+
+    // Calls work_(item_, thread_) for every item in [0, nItems_) on nThreads_ threads
+    template <typename Work>
+    void runParallel(int nItems_, int nThreads_, Work work_)
+    {
+        if (nThreads_ > nItems_) nThreads_ = nItems_;
+        if (nThreads_ <= 0) return;
+
+        std::vector<WorkRange> ranges(nThreads_);
+        for (int t = 0; t < nThreads_; t++)
+        {
+            ranges[t].next = static_cast<int>(static_cast<long long>(nItems_) * t / nThreads_);
+            ranges[t].end = static_cast<int>(static_cast<long long>(nItems_) * (t + 1) / nThreads_);
+        }
+
+        auto worker = [&](int thread_)
+        {
+            while (true)
+            {
+                int item = takeOwn(ranges[thread_]);
+                if (item < 0)
+                {
+                    if (!steal(ranges, thread_)) return;
+                    continue;
+                }
+
+                work_(item, thread_);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 1; t < nThreads_; t++) threads.emplace_back(worker, t);
+
+        // The calling thread does its share of the work too
+        worker(0);
+
+        for (std::thread& thread : threads) thread.join();
+    }
+
+    // Number of times the same board can come out equivalent to an earlier one before it is given up on.
+    // Only boards with very few digits removed have few enough distinct forms to get there.
+    const int maxRegenerations = 64;
+}
+
+int generateBatch(int nPuzzles_, int nDigitsToRemove_, int seedBoard_[9][9], GeneratedPuzzle* puzzles_, uint64_t seed_, int nThreads_, SolverBackend backend_, CanonicalSet* seen_)
+{
+    if (nPuzzles_ <= 0) return 0;
+
+    if (nThreads_ <= 0) nThreads_ = static_cast<int>(std::thread::hardware_concurrency());
+    if (nThreads_ <= 0) nThreads_ = 1;
+
+    // Boards still to be created, and the stream each one draws from. Boards created again take streams past the batch.
+    std::vector<int> pending(nPuzzles_);
+    std::vector<uint64_t> streams(nPuzzles_);
+    for (int i = 0; i < nPuzzles_; i++) pending[i] = i, streams[i] = static_cast<uint64_t>(i);
+    uint64_t nextStream = static_cast<uint64_t>(nPuzzles_);
+
+    std::vector<CanonicalKey> keys(seen_ ? nPuzzles_ : 0);
+    std::vector<bool> dropped(nPuzzles_, false);
+    int nRegenerated = 0;
+
+    for (int round = 0; !pending.empty(); round++)
+    {
+        runParallel(static_cast<int>(pending.size()), nThreads_, [&](int item_, int)
+        {
+            int index = pending[item_];
+            Rng rng = Rng::stream(seed_, streams[index]);
+            GeneratedPuzzle& puzzle = puzzles_[index];
+
+            while (!createBoard(nDigitsToRemove_, seedBoard_, puzzle.solved, puzzle.unsolved, rng, backend_))
+            {
+                continue;
+            }
+
+            if (seen_) keys[index] = canonicalKey(puzzle.unsolved, puzzle.solved);
+        });
+
+        if (!seen_) break;
+
+        std::vector<int> duplicates;
+        for (int index : pending)
+        {
+            if (seen_->insert(keys[index]).second) continue;
+
+            if (round == maxRegenerations) dropped[index] = true;
+            else
+            {
+                duplicates.push_back(index);
+                streams[index] = nextStream++;
+            }
+        }
+
+        nRegenerated += static_cast<int>(duplicates.size());
+        pending.swap(duplicates);
+    }
+
+    TRACE("Batch of " << nPuzzles_ << " boards: " << nRegenerated << " created again for being equivalent to earlier boards");
+
+    // Close the gaps left by boards that were given up on
+    int nKept = 0;
+    for (int i = 0; i < nPuzzles_; i++)
+    {
+        if (dropped[i]) continue;
+        if (nKept != i) puzzles_[nKept] = puzzles_[i];
+        nKept++;
+    }
+    return nKept;
+}
+
@@ -0,0 +1,531 @@
+/**
+* Author: Ryley Robinson
+*
+* bench.cpp: Microbenchmarks for the generator and solver stages. Built as the sudoku_bench target.
+*
+* Every benchmark runs over a fixed corpus, so results can be compared between versions:
+* - known:  well-known hard puzzles, up to the hardest known 17 clue puzzles.
+* - easy, medium, hard: puzzles generated from the seed board with a fixed seed, with 36, 26 and 21 digits given.
+*
+* Each benchmark repeats its operation until it has run for at least the minimum time, then reports the time per
+* operation, heap allocations per operation, and search nodes visited per operation where the solver counts them.
+*
+* Options:
+* --filter text      Only runs benchmarks whose name contains text.
+* --min-time s       Minimum time to run each benchmark for, in seconds. Defaults to 0.5.
+* --json file        Also writes the results to file, in the same JSON layout as Google Benchmark.
+* --expect-no-allocs Exits with 1 if any benchmark allocates on the heap once it has run once.
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "functions.h"
+
+namespace
+{
+    // Counts every heap allocation made by the program. Benchmarks only run on the main thread.
+    long long nAllocations = 0;
+}
+
+void* operator new(size_t size_)
+{
+    nAllocations++;
+    if (void* memory = std::malloc(size_ > 0 ? size_ : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory_) noexcept
+{
+    std::free(memory_);
+}
+
+void operator delete(void* memory_, size_t) noexcept
+{
+    std::free(memory_);
+}
+
+namespace
+{
+    // Same seed board as config.h. It is copied here because config.h defines its variables and can only be included once.
+    int seedBoard[9][9] = {
+        {2,3,7,8,4,1,5,6,9},
+        {1,8,6,7,9,5,2,4,3},
+        {5,9,4,3,2,6,7,1,8},
+        {3,1,5,6,7,4,8,9,2},
+        {4,6,9,5,8,2,1,3,7},
+        {7,2,8,1,3,9,4,5,6},
+        {6,4,2,9,1,8,3,7,5},
+        {8,5,3,4,6,7,9,2,1},
+        {9,7,1,2,5,3,6,8,4}
+    };
+
+    const char* knownPuzzles[] = {
+        // Peter Norvig's hard1
+        "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......",
+        // Arto Inkala's "world's hardest sudoku"
+        "8..........36......7..9.2...5...7.......457.....1...3...1....68..85...1..9....4..",
+        // Gordon Royle's 17 clue puzzles
+        "...........................1..2....3..4...5.....6.....7.8.....1...4.3....5....7..",
+        ".......1.4.........2...........5.4.7..8...3....1.9....3..4..2...5.1........8.6...",
+        ".......12....35......6...7.7.....3.....4..8..1...........12.....8.....4..5....6.."
+    };
+
+    const uint64_t corpusSeed = 20240611;
+    const int corpusSize = 32;
+
+    struct Puzzle
+    {
+        int unsolved[9][9];
+        int solved[9][9];
+
+        // The same boards in the compact form
+        Board unsolvedBoard;
+        Board solvedBoard;
+    };
+
+    struct Corpus
+    {
+        std::string name;
+        std::vector<Puzzle> puzzles;
+    };
+
+    std::vector<Corpus> buildCorpora()
+    {
+        std::vector<Corpus> corpora;
+
+        Corpus known = { "known", {} };
+        for (const char* line : knownPuzzles)
+        {
+            Puzzle puzzle;
+            for (int i = 0; i < 81; i++) puzzle.unsolved[i / 9][i % 9] = line[i] == '.' ? 0 : line[i] - '0';
+            std::memcpy(puzzle.solved, puzzle.unsolved, sizeof(puzzle.solved));
+            searchSolve(puzzle.solved);
+            puzzle.unsolvedBoard.load(puzzle.unsolved);
+            puzzle.solvedBoard.load(puzzle.solved);
+            known.puzzles.push_back(puzzle);
+        }
+        corpora.push_back(known);
+
+        const struct { const char* name; int nDigitsToRemove; } tiers[] = { { "easy", 45 }, { "medium", 55 }, { "hard", 60 } };
+        for (const auto& tier : tiers)
+        {
+            std::vector<GeneratedPuzzle> generated(corpusSize);
+            generateBatch(corpusSize, tier.nDigitsToRemove, seedBoard, generated.data(), corpusSeed, 1);
+
+            Corpus corpus = { tier.name, {} };
+            for (const GeneratedPuzzle& g : generated)
+            {
+                Puzzle puzzle;
+                std::memcpy(puzzle.unsolved, g.unsolved, sizeof(puzzle.unsolved));
+                std::memcpy(puzzle.solved, g.solved, sizeof(puzzle.solved));
+                puzzle.unsolvedBoard.load(puzzle.unsolved);
+                puzzle.solvedBoard.load(puzzle.solved);
+                corpus.puzzles.push_back(puzzle);
+            }
+            corpora.push_back(corpus);
+        }
+
+        return corpora;
+    }
+
+    struct Result
+    {
+        std::string name;
+        long long iterations = 0;
+        double realNanos = 0;
+        double cpuNanos = 0;
+        double allocations = 0;
+        double nodes = -1;
+    };
+
+    struct Options
+    {
+        std::string filter;
+        double minSeconds = 0.5;
+        std::string jsonPath;
+        bool expectNoAllocations = false;
+    };
+
+    /*
+    * Runs operation_ in growing batches until a batch takes at least the minimum time, then reports that batch.
+    * operation_ is given the index of the iteration and the stats to count nodes in, and returns how many
+    * operations it performed.
+    */
+    Result runBenchmark(const std::string& name_, const Options& options_, bool countsNodes_, const std::function<int(long long, SearchStats&)>& operation_)
+    {
+        Result result;
+        result.name = name_;
+
+        // One untimed run first, so scratch space kept between runs is already allocated when counting starts
+        SearchStats warmup;
+        operation_(0, warmup);
+
+        for (long long batch = 1;; batch *= 2)
+        {
+            SearchStats stats;
+            long long nOperations = 0;
+            long long allocationsBefore = nAllocations;
+            std::clock_t cpuStart = std::clock();
+            auto start = std::chrono::steady_clock::now();
+
+            for (long long i = 0; i < batch; i++) nOperations += operation_(i, stats);
+
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            double cpuSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+            if (seconds >= options_.minSeconds || batch >= (1LL << 40))
+            {
+                result.iterations = nOperations;
+                result.realNanos = seconds * 1e9 / nOperations;
+                result.cpuNanos = cpuSeconds * 1e9 / nOperations;
+                result.allocations = static_cast<double>(nAllocations - allocationsBefore) / nOperations;
+                if (countsNodes_) result.nodes = static_cast<double>(stats.nodesVisited) / nOperations;
+                return result;
+            }
+        }
+    }
+
+    void printResult(const Result& result_)
+    {
+        std::cout << std::left << std::setw(32) << result_.name << std::right
+            << std::setw(14) << std::fixed << std::setprecision(0) << result_.realNanos << " ns"
+            << std::setw(14) << result_.cpuNanos << " ns"
+            << std::setw(12) << result_.iterations
+            << std::setw(12) << std::setprecision(2) << result_.allocations;
+        if (result_.nodes >= 0) std::cout << std::setw(14) << std::setprecision(1) << result_.nodes;
+        std::cout << std::endl;
+    }
+
+    void writeJson(std::ostream& out_, const std::vector<Result>& results_)
+    {
+        char date[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+        out_ << "{\n";
+        out_ << "  \"context\": {\n";
+        out_ << "    \"date\": \"" << date << "\",\n";
+        out_ << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#if defined(NDEBUG)
+        out_ << "    \"library_build_type\": \"release\",\n";
+#else
+        out_ << "    \"library_build_type\": \"debug\",\n";
+#endif
+        out_ << "    \"batch_solve_isa\": \"" << batchSolveIsa() << "\",\n";
+        out_ << "    \"corpus_seed\": " << corpusSeed << "\n";
+        out_ << "  },\n";
+        out_ << "  \"benchmarks\": [\n";
+
+        for (size_t i = 0; i < results_.size(); i++)
+        {
+            const Result& result = results_[i];
+            out_ << "    {\n";
+            out_ << "      \"name\": \"" << result.name << "\",\n";
+            out_ << "      \"run_type\": \"iteration\",\n";
+            out_ << "      \"iterations\": " << result.iterations << ",\n";
+            out_ << "      \"real_time\": " << std::fixed << std::setprecision(3) << result.realNanos << ",\n";
+            out_ << "      \"cpu_time\": " << result.cpuNanos << ",\n";
+            out_ << "      \"time_unit\": \"ns\",\n";
+            out_ << "      \"allocs_per_op\": " << result.allocations;
+            if (result.nodes >= 0) out_ << ",\n      \"nodes_per_op\": " << result.nodes;
+            out_ << "\n    }" << (i + 1 < results_.size() ? "," : "") << "\n";
+        }
+
+        out_ << "  ]\n";
+        out_ << "}\n";
+    }
+
+    // Copies puzzle i of the corpus (wrapping around) to board_, and returns it
+    const Puzzle& takePuzzle(const Corpus& corpus_, long long i_, int board_[9][9])
+    {
+        const Puzzle& puzzle = corpus_.puzzles[i_ % corpus_.puzzles.size()];
+        std::memcpy(board_, puzzle.unsolved, sizeof(puzzle.unsolved));
+        return puzzle;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = argv[i];
+
+        if (option == "--filter" && i + 1 < argc) options.filter = argv[++i];
+        else if (option == "--min-time" && i + 1 < argc) options.minSeconds = atof(argv[++i]);
+        else if (option == "--json" && i + 1 < argc) options.jsonPath = argv[++i];
+        else if (option == "--expect-no-allocs") options.expectNoAllocations = true;
+        else
+        {
+            std::cout << "Unknown option \"" << option << "\"." << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Corpus> corpora = buildCorpora();
+    std::vector<Result> results;
+
+    auto run = [&](const std::string& name_, bool countsNodes_, const std::function<int(long long, SearchStats&)>& operation_)
+    {
+        if (name_.find(options.filter) == std::string::npos) return;
+
+        results.push_back(runBenchmark(name_, options, countsNodes_, operation_));
+        printResult(results.back());
+    };
+
+    std::cout << std::left << std::setw(32) << "Benchmark" << std::right
+        << std::setw(17) << "Time" << std::setw(17) << "CPU" << std::setw(12) << "Iterations"
+        << std::setw(12) << "Allocs/op" << std::setw(14) << "Nodes/op" << std::endl;
+    std::cout << std::string(104, '-') << std::endl;
+
+    // Generator
+    for (int nDigitsToRemove : { 45, 55, 60 })
+    {
+        Rng rng(corpusSeed);
+        run("createBoard/" + std::to_string(nDigitsToRemove), false, [&](long long, SearchStats&)
+        {
+            int solved[9][9], unsolved[9][9];
+            while (!createBoard(nDigitsToRemove, seedBoard, solved, unsolved, rng))
+            {
+                continue;
+            }
+            return 1;
+        });
+    }
+
+    for (int nClues : { 24, 22, 0 })
+    {
+        Rng rng(corpusSeed);
+        run("generateGrid/" + (nClues > 0 ? std::to_string(nClues) : std::string("minimal")), false, [&](long long, SearchStats&)
+        {
+            int solved[9][9], unsolved[9][9];
+            generateGrid<3>(nClues, seedBoard, solved, unsolved, rng);
+            return 1;
+        });
+    }
+
+    {
+        Rng rng(corpusSeed);
+        run("generateForDifficulty/30-40", false, [&](long long, SearchStats&)
+        {
+            int solved[9][9], unsolved[9][9];
+            generateForDifficulty(30, 40, seedBoard, solved, unsolved, rng);
+            return 1;
+        });
+    }
+
+    // Solvers
+    for (const Corpus& corpus : corpora)
+    {
+        run("solveBoard/" + corpus.name, false, [&](long long i_, SearchStats&)
+        {
+            int board[9][9];
+            takePuzzle(corpus, i_, board);
+            solveBoard(board);
+            return 1;
+        });
+
+        run("gradeBoard/" + corpus.name, false, [&](long long i_, SearchStats&)
+        {
+            int board[9][9];
+            takePuzzle(corpus, i_, board);
+            gradeBoard(board);
+            return 1;
+        });
+
+        run("searchSolve/" + corpus.name, true, [&](long long i_, SearchStats& stats_)
+        {
+            int board[9][9];
+            takePuzzle(corpus, i_, board);
+            searchSolve(board, &stats_);
+            return 1;
+        });
+
+        SearchEngine engine;
+        run("iterativeSolve/" + corpus.name, true, [&](long long i_, SearchStats& stats_)
+        {
+            engine.load(corpus.puzzles[i_ % corpus.puzzles.size()].unsolvedBoard);
+            engine.run();
+            stats_.nodesVisited += engine.nodesVisited();
+            return 1;
+        });
+
+        run("dlxSolve/" + corpus.name, true, [&](long long i_, SearchStats& stats_)
+        {
+            int board[9][9];
+            takePuzzle(corpus, i_, board);
+            dlxSolve(board, &stats_);
+            return 1;
+        });
+
+        std::vector<int> batchStorage(corpus.puzzles.size() * 81);
+        run("batchSolve/" + corpus.name, false, [&](long long, SearchStats&)
+        {
+            // One operation here is one puzzle of the batch
+            int (*boards)[9][9] = reinterpret_cast<int (*)[9][9]>(batchStorage.data());
+            for (size_t p = 0; p < corpus.puzzles.size(); p++) std::memcpy(boards[p], corpus.puzzles[p].unsolved, sizeof(boards[p]));
+            batchSolve(boards, static_cast<int>(corpus.puzzles.size()));
+            return static_cast<int>(corpus.puzzles.size());
+        });
+
+        // The plain backtracking search takes seconds to minutes on the harder puzzles
+        if (corpus.name == "easy" || corpus.name == "medium")
+        {
+            run("recursiveSolve/" + corpus.name, true, [&](long long i_, SearchStats& stats_)
+            {
+                Board board = corpus.puzzles[i_ % corpus.puzzles.size()].unsolvedBoard;
+                recursiveSolve(board, &stats_);
+                return 1;
+            });
+        }
+    }
+
+    // Checks, on the medium corpus. The results go to a volatile so the calls can't be optimized away.
+    Corpus& medium = corpora[2];
+    volatile bool checked = false;
+
+    run("sanityCheck/solved", false, [&](long long i_, SearchStats&)
+    {
+        checked = sanityCheck(medium.puzzles[i_ % medium.puzzles.size()].solvedBoard);
+        return 1;
+    });
+
+    std::vector<Board> solvedBoards;
+    for (const Puzzle& puzzle : medium.puzzles) solvedBoards.push_back(puzzle.solvedBoard);
+    run("sanityCheckBatch/solved", false, [&](long long, SearchStats&)
+    {
+        // One operation here is one board of the batch
+        checked = sanityCheckBatch(solvedBoards.data(), static_cast<int>(solvedBoards.size())) == static_cast<int>(solvedBoards.size());
+        return static_cast<int>(solvedBoards.size());
+    });
+
+    run("checkSolution/solved", false, [&](long long i_, SearchStats&)
+    {
+        Puzzle& puzzle = medium.puzzles[i_ % medium.puzzles.size()];
+        checked = checkSolution(puzzle.solvedBoard, puzzle.solvedBoard);
+        return 1;
+    });
+
+    run("canonicalBoard/medium", false, [&](long long i_, SearchStats&)
+    {
+        Puzzle& puzzle = medium.puzzles[i_ % medium.puzzles.size()];
+        int canonical[9][9];
+        canonicalBoard(puzzle.unsolved, puzzle.solved, canonical);
+        checked = canonical[0][0] != 0;
+        return 1;
+    });
+
+    // Each human method on its own, starting from the working board of each medium puzzle.
+    // Ruled out digits are only left behind once singles have been placed, so that method starts one step later.
+    std::vector<CandidateBoard> workingBoards(medium.puzzles.size()), placedBoards(medium.puzzles.size());
+    for (size_t p = 0; p < medium.puzzles.size(); p++)
+    {
+        int board[9][9];
+        takePuzzle(medium, p, board);
+        workingBoards[p].load(board);
+        placedBoards[p] = workingBoards[p];
+        placeSingles(placedBoards[p], board);
+    }
+
+    run("technique/placeSingles", false, [&](long long i_, SearchStats&)
+    {
+        int board[9][9];
+        takePuzzle(medium, i_, board);
+        CandidateBoard workingBoard = workingBoards[i_ % workingBoards.size()];
+        placeSingles(workingBoard, board);
+        return 1;
+    });
+
+    run("technique/removeRuledOut", false, [&](long long i_, SearchStats&)
+    {
+        CandidateBoard workingBoard = placedBoards[i_ % placedBoards.size()];
+        removeRuledOut(workingBoard);
+        return 1;
+    });
+
+    run("technique/findHiddenSingles", false, [&](long long i_, SearchStats&)
+    {
+        CandidateBoard workingBoard = workingBoards[i_ % workingBoards.size()];
+        findHiddenSingles(workingBoard);
+        return 1;
+    });
+
+    run("technique/findNakedPairs", false, [&](long long i_, SearchStats&)
+    {
+        CandidateBoard workingBoard = workingBoards[i_ % workingBoards.size()];
+        findNakedPairs(workingBoard);
+        return 1;
+    });
+
+    run("technique/findHiddenPairs", false, [&](long long i_, SearchStats&)
+    {
+        CandidateBoard workingBoard = workingBoards[i_ % workingBoards.size()];
+        findHiddenPairs(workingBoard);
+        return 1;
+    });
+
+    run("technique/findPointingPairs", false, [&](long long i_, SearchStats&)
+    {
+        CandidateBoard workingBoard = workingBoards[i_ % workingBoards.size()];
+        findPointingPairs(workingBoard);
+        return 1;
+    });
+
+    run("technique/findBoxLineReductions", false, [&](long long i_, SearchStats&)
+    {
+        CandidateBoard workingBoard = workingBoards[i_ % workingBoards.size()];
+        findBoxLineReductions(workingBoard);
+        return 1;
+    });
+
+    run("technique/findXWings", false, [&](long long i_, SearchStats&)
+    {
+        CandidateBoard workingBoard = workingBoards[i_ % workingBoards.size()];
+        findXWings(workingBoard);
+        return 1;
+    });
+
+    run("technique/findSwordfish", false, [&](long long i_, SearchStats&)
+    {
+        CandidateBoard workingBoard = workingBoards[i_ % workingBoards.size()];
+        findSwordfish(workingBoard);
+        return 1;
+    });
+
+    if (!options.jsonPath.empty())
+    {
+        std::ofstream json(options.jsonPath);
+        if (!json)
+        {
+            std::cerr << "Could not open \"" << options.jsonPath << "\"." << std::endl;
+            return 1;
+        }
+        writeJson(json, results);
+    }
+
+    if (options.expectNoAllocations)
+    {
+        int nAllocating = 0;
+        for (const Result& result : results)
+        {
+            if (result.allocations == 0) continue;
+
+            std::cerr << result.name << " allocates " << result.allocations << " times per operation." << std::endl;
+            nAllocating++;
+        }
+        if (nAllocating > 0) return 1;
+    }
+
+    return 0;
+}
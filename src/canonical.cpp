@@ -0,0 +1,228 @@
+/**
+* Author: Ryley Robinson
+*
+* canonical.cpp: Canonical forms of 9 x 9 boards. Declared in functions.h.
+*
+* Two boards are equivalent if one can be turned into the other by reordering bands, stacks, the rows within a band
+* and the columns within a stack, transposing, and relabelling the digits. The canonical form is the smallest board,
+* read row by row, that a board's solution can be turned into, and of the ways to get there, the one that leaves the
+* smallest puzzle. Since a well-posed puzzle has just the one solution, equivalent puzzles get the same canonical form.
+*
+* After relabelling, the first row of any solution reads 1 to 9, so only the choice of the second row and the column
+* order can make a difference up front. Those are tried exhaustively (36 row pairs and 1296 column orders per side),
+* and only the ones that tie for the smallest first band are finished. Once the first row fixes the labels, the
+* other two bands are simply put in order.
+*/
+
+#include <algorithm>
+#include <vector>
+#include "functions.h"
+
+namespace
+{
+    const int nColumnOrders = 1296;
+
+    const int orders3[6][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+
+    // Every order of the columns that keeps the columns of each stack together: 6 orders of the stacks,
+    // and 6 orders of the columns in each of them
+    struct ColumnOrders
+    {
+        // Column moved to position j
+        uint8_t column[nColumnOrders][9];
+
+        // Position column c is moved to
+        uint8_t position[nColumnOrders][9];
+    };
+
+    ColumnOrders makeColumnOrders()
+    {
+        ColumnOrders orders;
+        for (int k = 0; k < nColumnOrders; k++)
+        {
+            int stacks = k / 216;
+            int within[3] = { (k / 36) % 6, (k / 6) % 6, k % 6 };
+
+            for (int j = 0; j < 9; j++)
+            {
+                int c = 3 * orders3[stacks][j / 3] + orders3[within[j / 3]][j % 3];
+                orders.column[k][j] = static_cast<uint8_t>(c);
+                orders.position[k][c] = static_cast<uint8_t>(j);
+            }
+        }
+        return orders;
+    }
+
+    const ColumnOrders& columnOrders()
+    {
+        static const ColumnOrders orders = makeColumnOrders();
+        return orders;
+    }
+
+    // A way of turning the solution into one with the smallest first band found so far
+    struct Candidate
+    {
+        uint8_t transposed;
+        uint8_t row0;
+        uint8_t row1;
+        uint16_t order;
+    };
+
+    // Applies one candidate to the board and its solution, writing both out row by row
+    void finish(const Candidate& candidate_, int solved_[2][9][9], int unsolved_[2][9][9], uint8_t solvedOut_[81], uint8_t unsolvedOut_[81])
+    {
+        const ColumnOrders& orders = columnOrders();
+        const uint8_t* column = orders.column[candidate_.order];
+        const uint8_t* position = orders.position[candidate_.order];
+        int (*solved)[9] = solved_[candidate_.transposed];
+        int (*unsolved)[9] = unsolved_[candidate_.transposed];
+
+        // The digit in column c of the first row becomes the digit of that column's new position
+        int label[10] = {};
+        for (int c = 0; c < 9; c++) label[solved[candidate_.row0][c]] = position[c] + 1;
+
+        uint8_t rows[9][9];
+        for (int r = 0; r < 9; r++)
+        {
+            for (int j = 0; j < 9; j++) rows[r][j] = static_cast<uint8_t>(label[solved[r][column[j]]]);
+        }
+
+        auto less = [&](int a_, int b_) { return std::lexicographical_compare(rows[a_], rows[a_] + 9, rows[b_], rows[b_] + 9); };
+
+        int band0 = candidate_.row0 / 3;
+        int order[9] = { candidate_.row0, candidate_.row1, 9 * band0 + 3 - candidate_.row0 - candidate_.row1 };
+
+        // Rows of the other bands in order, then the bands by their first row
+        int others[2][3], nOthers = 0;
+        for (int b = 0; b < 3; b++)
+        {
+            if (b == band0) continue;
+            for (int i = 0; i < 3; i++) others[nOthers][i] = 3 * b + i;
+            std::sort(others[nOthers], others[nOthers] + 3, less);
+            nOthers++;
+        }
+        if (less(others[1][0], others[0][0])) std::swap(others[0], others[1]);
+        for (int i = 0; i < 6; i++) order[3 + i] = others[i / 3][i % 3];
+
+        for (int i = 0; i < 81; i++)
+        {
+            int r = order[i / 9];
+            solvedOut_[i] = rows[r][i % 9];
+            unsolvedOut_[i] = static_cast<uint8_t>(unsolved[r][column[i % 9]] != 0 ? rows[r][i % 9] : 0);
+        }
+    }
+}
+
+void canonicalBoard(int unsolvedBoard_[9][9], int solvedBoard_[9][9], int canonicalUnsolved_[9][9], int canonicalSolved_[9][9])
+{
+    const ColumnOrders& orders = columnOrders();
+
+    int solved[2][9][9], unsolved[2][9][9];
+    for (int r = 0; r < 9; r++)
+    {
+        for (int c = 0; c < 9; c++)
+        {
+            solved[0][r][c] = solved[1][c][r] = solvedBoard_[r][c];
+            unsolved[0][r][c] = unsolved[1][c][r] = unsolvedBoard_[r][c];
+        }
+    }
+
+    // The second and third rows of the best candidates, which the first two rows of the band fix
+    uint8_t bestRows[18] = {};
+    bool found = false;
+
+    // Kept from one call to the next, so it only allocates when a board has more candidates than any before it
+    static thread_local std::vector<Candidate> scratch;
+    std::vector<Candidate>& candidates = scratch;
+    candidates.clear();
+
+    for (int t = 0; t < 2; t++)
+    {
+        for (int row0 = 0; row0 < 9; row0++)
+        {
+            int columnOf[10];
+            for (int c = 0; c < 9; c++) columnOf[solved[t][row0][c]] = c;
+
+            for (int row1 = 3 * (row0 / 3); row1 < 3 * (row0 / 3) + 3; row1++)
+            {
+                if (row1 == row0) continue;
+
+                // Column of the first row holding the digit in column c of the second and third rows
+                int row2 = 9 * (row0 / 3) + 3 - row0 - row1;
+                uint8_t below[18];
+                for (int c = 0; c < 9; c++)
+                {
+                    below[c] = static_cast<uint8_t>(columnOf[solved[t][row1][c]]);
+                    below[9 + c] = static_cast<uint8_t>(columnOf[solved[t][row2][c]]);
+                }
+
+                for (int k = 0; k < nColumnOrders; k++)
+                {
+                    const uint8_t* column = orders.column[k];
+                    const uint8_t* position = orders.position[k];
+
+                    // The second and third rows after relabelling, compared with the smallest ones so far
+                    int compare = found ? 0 : -1;
+                    for (int j = 0; j < 9 && compare == 0; j++)
+                    {
+                        int n = position[below[column[j]]];
+                        if (n != bestRows[j]) compare = n < bestRows[j] ? -1 : 1;
+                    }
+                    for (int j = 0; j < 9 && compare == 0; j++)
+                    {
+                        int n = position[below[9 + column[j]]];
+                        if (n != bestRows[9 + j]) compare = n < bestRows[9 + j] ? -1 : 1;
+                    }
+
+                    if (compare > 0) continue;
+                    if (compare < 0)
+                    {
+                        for (int j = 0; j < 18; j++) bestRows[j] = position[below[9 * (j / 9) + column[j % 9]]];
+                        candidates.clear();
+                        found = true;
+                    }
+                    candidates.push_back({ static_cast<uint8_t>(t), static_cast<uint8_t>(row0), static_cast<uint8_t>(row1), static_cast<uint16_t>(k) });
+                }
+            }
+        }
+    }
+
+    // Usually a single candidate is left; more only if the first band has symmetries
+    uint8_t bestSolved[81], bestUnsolved[81], nextSolved[81], nextUnsolved[81];
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        finish(candidates[i], solved, unsolved, nextSolved, nextUnsolved);
+
+        int compare = i == 0 ? -1 : 0;
+        for (int j = 0; j < 81 && compare == 0; j++)
+        {
+            if (nextSolved[j] != bestSolved[j]) compare = nextSolved[j] < bestSolved[j] ? -1 : 1;
+        }
+        for (int j = 0; j < 81 && compare == 0; j++)
+        {
+            if (nextUnsolved[j] != bestUnsolved[j]) compare = nextUnsolved[j] < bestUnsolved[j] ? -1 : 1;
+        }
+
+        if (compare < 0)
+        {
+            std::copy(nextSolved, nextSolved + 81, bestSolved);
+            std::copy(nextUnsolved, nextUnsolved + 81, bestUnsolved);
+        }
+    }
+
+    for (int i = 0; i < 81; i++)
+    {
+        canonicalUnsolved_[i / 9][i % 9] = bestUnsolved[i];
+        if (canonicalSolved_) canonicalSolved_[i / 9][i % 9] = bestSolved[i];
+    }
+}
+
+CanonicalKey canonicalKey(int unsolvedBoard_[9][9], int solvedBoard_[9][9])
+{
+    int canonical[9][9];
+    canonicalBoard(unsolvedBoard_, solvedBoard_, canonical);
+
+    CanonicalKey key = {};
+    for (int i = 0; i < 81; i++) key.words[i / 16] |= static_cast<uint64_t>(canonical[i / 9][i % 9]) << (4 * (i % 16));
+    return key;
+}
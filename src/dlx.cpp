@@ -0,0 +1,230 @@
+/**
+* Author: Ryley Robinson
+*
+* dlx.cpp: Dancing links exact cover solver. Declared in dlx.h and functions.h.
+*
+* Algorithm X:
+* - If every column is covered, a solution has been found.
+* - Otherwise choose the column with the fewest rows left.
+* - For each of its rows: select the row, cover every column it satisfies, search deeper, then undo.
+*/
+
+#include "dlx.h"
+#include "functions.h"
+
+namespace
+{
+    // Matrix row for digit n_ (1-9) in space index_
+    inline int matrixRow(int index_, int n_)
+    {
+        return 9 * index_ + n_ - 1;
+    }
+}
+
+DlxSolver::DlxSolver()
+{
+    // Column headers form a circular list around the root.
+    for (int c = 0; c <= nColumns; c++)
+    {
+        left[c] = c == 0 ? nColumns : c - 1;
+        right[c] = c == nColumns ? 0 : c + 1;
+        up[c] = down[c] = column[c] = c;
+        rowOf[c] = -1;
+        size[c] = 0;
+    }
+
+    // Each row has four nodes, one in each of the constraint columns it satisfies.
+    for (int r = 0; r < nRows; r++)
+    {
+        int index = r / 9, n = r % 9;
+        int row = index / 9, col = index % 9;
+        int columns[4] = {
+            1 + index,
+            1 + 81 + 9 * row + n,
+            1 + 162 + 9 * col + n,
+            1 + 243 + 9 * Cand::squareOf(row, col) + n
+        };
+
+        int first = 1 + nColumns + 4 * r;
+        for (int k = 0; k < 4; k++)
+        {
+            int node = first + k;
+            int c = columns[k];
+
+            column[node] = c;
+            rowOf[node] = r;
+            left[node] = first + (k + 3) % 4;
+            right[node] = first + (k + 1) % 4;
+
+            up[node] = up[c];
+            down[node] = c;
+            down[up[c]] = node;
+            up[c] = node;
+            size[c]++;
+        }
+    }
+
+    nGivenColumns = 0;
+    solutionFound = false;
+}
+
+void DlxSolver::cover(int column_)
+{
+    right[left[column_]] = right[column_];
+    left[right[column_]] = left[column_];
+
+    for (int i = down[column_]; i != column_; i = down[i])
+    {
+        for (int j = right[i]; j != i; j = right[j])
+        {
+            down[up[j]] = down[j];
+            up[down[j]] = up[j];
+            size[column[j]]--;
+        }
+    }
+}
+
+void DlxSolver::uncover(int column_)
+{
+    for (int i = up[column_]; i != column_; i = up[i])
+    {
+        for (int j = left[i]; j != i; j = left[j])
+        {
+            size[column[j]]++;
+            down[up[j]] = j;
+            up[down[j]] = j;
+        }
+    }
+
+    right[left[column_]] = column_;
+    left[right[column_]] = column_;
+}
+
+bool DlxSolver::applyGivens(int board_[9][9])
+{
+    bool covered[1 + nColumns] = {};
+    nGivenColumns = 0;
+
+    for (int i = 0; i < 81; i++)
+    {
+        int n = board_[i / 9][i % 9];
+        if (n == 0) continue;
+
+        int first = 1 + nColumns + 4 * matrixRow(i, n);
+
+        // Two givens that satisfy the same constraint can't both be part of a solution
+        for (int k = 0; k < 4; k++)
+        {
+            if (covered[column[first + k]])
+            {
+                removeGivens();
+                return false;
+            }
+        }
+
+        for (int k = 0; k < 4; k++)
+        {
+            covered[column[first + k]] = true;
+            givenColumns[nGivenColumns++] = column[first + k];
+            cover(column[first + k]);
+        }
+    }
+
+    return true;
+}
+
+void DlxSolver::removeGivens()
+{
+    while (nGivenColumns > 0) uncover(givenColumns[--nGivenColumns]);
+}
+
+int DlxSolver::search(int depth_, int limit_, SearchStats* stats_)
+{
+    if (stats_) stats_->nodesVisited++;
+
+    if (right[root] == root)
+    {
+        if (!solutionFound)
+        {
+            for (int d = 0; d < depth_; d++) solution[path[d] / 9] = static_cast<uint8_t>(path[d] % 9 + 1);
+            solutionFound = true;
+        }
+        return 1;
+    }
+
+    // Choose the column with the fewest rows left
+    int best = right[root];
+    for (int c = right[best]; c != root && size[best] > 1; c = right[c])
+    {
+        if (size[c] < size[best]) best = c;
+    }
+
+    if (size[best] == 0) return 0;
+
+    cover(best);
+
+    int found = 0;
+    for (int r = down[best]; r != best && found < limit_; r = down[r])
+    {
+        path[depth_] = rowOf[r];
+
+        for (int j = right[r]; j != r; j = right[j]) cover(column[j]);
+
+        found += search(depth_ + 1, limit_ - found, stats_);
+
+        for (int j = left[r]; j != r; j = left[j]) uncover(column[j]);
+    }
+
+    uncover(best);
+
+    return found;
+}
+
+bool DlxSolver::solve(int board_[9][9], SearchStats* stats_)
+{
+    if (!applyGivens(board_)) return false;
+
+    solutionFound = false;
+    search(0, 1, stats_);
+    removeGivens();
+
+    if (!solutionFound) return false;
+
+    for (int i = 0; i < 81; i++)
+    {
+        if (board_[i / 9][i % 9] == 0) board_[i / 9][i % 9] = solution[i];
+    }
+
+    return true;
+}
+
+int DlxSolver::countSolutions(int board_[9][9], int limit_, SearchStats* stats_)
+{
+    if (!applyGivens(board_)) return 0;
+
+    solutionFound = false;
+    int found = search(0, limit_, stats_);
+    removeGivens();
+
+    return found;
+}
+
+namespace
+{
+    // One matrix per thread, linked on first use and reused by every later search
+    DlxSolver& threadDlxSolver()
+    {
+        thread_local DlxSolver solver;
+        return solver;
+    }
+}
+
+bool dlxSolve(int board_[9][9], SearchStats* stats_)
+{
+    return threadDlxSolver().solve(board_, stats_);
+}
+
+int dlxCountSolutions(int board_[9][9], int limit_, SearchStats* stats_)
+{
+    return threadDlxSolver().countSolutions(board_, limit_, stats_);
+}
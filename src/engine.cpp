@@ -0,0 +1,152 @@
+/**
+* Author: Ryley Robinson
+*
+* engine.cpp: Iterative backtracking search with an explicit stack and an undo trail. Declared in engine.h.
+*/
+
+#include <climits>
+#include "engine.h"
+
+bool SearchEngine::load(int board_[9][9])
+{
+    Board board;
+    board.load(board_);
+    return load(board);
+}
+
+bool SearchEngine::load(const Board& board_)
+{
+    for (int i = 0; i < T::size; i++) state.rowUsed[i] = state.colUsed[i] = state.squUsed[i] = 0;
+    for (int i = 0; i < T::cells; i++) state.digits[i] = 0;
+    state.nEmpty = T::cells;
+    trailSize = 0;
+    nChoices = 0;
+    nodes = 0;
+    solutions = 0;
+    step = Step::Done;
+
+    for (int i = 0; i < T::cells; i++)
+    {
+        int n = board_.cells[i];
+        if (n == 0) continue;
+
+        if (n > T::size || (state.possible(i) & Grid::digitMask<Mask>(n)) == 0) return false;
+        place(i, n);
+    }
+
+    // The givens are never undone, so the trail starts after them
+    trailSize = 0;
+    step = Step::Propagate;
+    return true;
+}
+
+void SearchEngine::store(int board_[9][9]) const
+{
+    for (int i = 0; i < T::cells; i++) board_[i / 9][i % 9] = state.digits[i];
+}
+
+void SearchEngine::store(Board& board_) const
+{
+    for (int i = 0; i < T::cells; i++) board_.cells[i] = state.digits[i];
+}
+
+bool SearchEngine::split(Board& board_)
+{
+    for (int c = 0; c < nChoices; c++)
+    {
+        Choice& choice = choices[c];
+        if (choice.untried == 0) continue;
+
+        // Empty every space filled in since the guess was made
+        for (int i = 0; i < T::cells; i++) board_.cells[i] = state.digits[i];
+        for (int t = choice.trailMark; t < trailSize; t++) board_.cells[trail[t]] = 0;
+
+        board_.cells[choice.index] = static_cast<uint8_t>(Grid::firstDigit(choice.untried));
+        choice.untried &= choice.untried - 1;
+        return true;
+    }
+
+    return false;
+}
+
+void SearchEngine::place(int index_, int n_)
+{
+    state.place(index_, n_);
+    trail[trailSize++] = static_cast<uint8_t>(index_);
+}
+
+void SearchEngine::undoTo(int trailMark_)
+{
+    while (trailSize > trailMark_) state.remove(trail[--trailSize]);
+}
+
+SearchStatus SearchEngine::run(const SearchLimits& limits_)
+{
+    // Reading the clock costs more than a cancel flag, so the time limit is only checked every few nodes
+    const long long timeCheckInterval = 64;
+
+    const bool timed = limits_.maxTime.count() > 0;
+    const auto start = timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    const long long lastNode = limits_.maxNodes > 0 ? nodes + limits_.maxNodes : LLONG_MAX;
+    long long nodesThisRun = 0;
+
+    while (true)
+    {
+        switch (step)
+        {
+        case Step::Done:
+            return SearchStatus::Exhausted;
+
+        case Step::Propagate:
+        {
+            if (nodes >= lastNode) return SearchStatus::OutOfBudget;
+            if (limits_.cancel && limits_.cancel->load(std::memory_order_relaxed)) return SearchStatus::Cancelled;
+            if (timed && ++nodesThisRun % timeCheckInterval == 0 && std::chrono::steady_clock::now() - start >= limits_.maxTime)
+            {
+                return SearchStatus::OutOfBudget;
+            }
+
+            nodes++;
+            step = Step::Advance;
+
+            if (!state.propagate([&](int index_) { trail[trailSize++] = static_cast<uint8_t>(index_); })) break;
+
+            if (state.nEmpty == 0)
+            {
+                solutions++;
+                return SearchStatus::Solved;
+            }
+
+            int index = state.pickSpace();
+            choices[nChoices++] = { static_cast<uint8_t>(index), state.possible(index), static_cast<uint8_t>(trailSize) };
+            break;
+        }
+
+        case Step::Advance:
+        {
+            // Back out of every guess that has no digits left to try
+            while (nChoices > 0 && choices[nChoices - 1].untried == 0)
+            {
+                undoTo(choices[nChoices - 1].trailMark);
+                nChoices--;
+            }
+
+            if (nChoices == 0)
+            {
+                step = Step::Done;
+                return SearchStatus::Exhausted;
+            }
+
+            Choice& choice = choices[nChoices - 1];
+            undoTo(choice.trailMark);
+
+            int n = Grid::firstDigit(choice.untried);
+            choice.untried &= choice.untried - 1;
+            place(choice.index, n);
+
+            step = Step::Propagate;
+            break;
+        }
+        }
+    }
+}
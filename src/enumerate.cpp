@@ -0,0 +1,146 @@
+/**
+* Author: Ryley Robinson
+*
+* enumerate.cpp: Writing and reading solution files. Declared in enumerate.h.
+*/
+
+#include <cstring>
+#include "enumerate.h"
+
+namespace
+{
+    const char solutionMagic[8] = { 'S', 'U', 'D', 'O', 'K', 'S', 'O', 'L' };
+    const uint16_t solutionVersion = 1;
+
+    // Records are gathered into blocks of this many bytes before they are written
+    const size_t blockSize = 1 << 16;
+
+    // The header is written and read as it is laid out in memory, so the host has to be little-endian
+    bool hostIsLittleEndian()
+    {
+        const uint16_t probe = 1;
+        return *reinterpret_cast<const uint8_t*>(&probe) == 1;
+    }
+
+    // The empty spaces of the puzzle, in order. Returns how many there are.
+    int findEmpty(const Board& puzzle_, uint8_t empty_[81])
+    {
+        int nEmpty = 0;
+        for (int i = 0; i < 81; i++)
+        {
+            if (puzzle_.cells[i] == 0) empty_[nEmpty++] = static_cast<uint8_t>(i);
+        }
+        return nEmpty;
+    }
+
+    SolutionFileHeader makeHeader(const Board& puzzle_, int recordSize_, uint64_t nSolutions_)
+    {
+        SolutionFileHeader header = {};
+        std::memcpy(header.magic, solutionMagic, sizeof(solutionMagic));
+        header.nSolutions = nSolutions_;
+        header.version = solutionVersion;
+        header.recordSize = static_cast<uint16_t>(recordSize_);
+
+        for (int i = 0; i < 81; i++) header.puzzle[i / 2] |= static_cast<uint8_t>(i % 2 == 0 ? puzzle_.cells[i] : puzzle_.cells[i] << 4);
+        return header;
+    }
+}
+
+bool SolutionWriter::open(const std::string& path_, const Board& puzzle_)
+{
+    nSolutions = 0;
+    blockUsed = 0;
+    if (!hostIsLittleEndian()) return false;
+
+    puzzle = puzzle_;
+    nEmpty = findEmpty(puzzle, empty);
+    block.resize(blockSize - blockSize % (recordSize() > 0 ? recordSize() : 1));
+
+    file.open(path_, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+
+    // Written again with the final count when the file is closed
+    SolutionFileHeader header = makeHeader(puzzle, recordSize(), 0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return static_cast<bool>(file);
+}
+
+bool SolutionWriter::append(const Board& solution_)
+{
+    if (blockUsed == block.size() && !writeBlock()) return false;
+
+    uint8_t* record = reinterpret_cast<uint8_t*>(block.data() + blockUsed);
+    for (int j = 0; j + 1 < nEmpty; j += 2)
+    {
+        record[j / 2] = static_cast<uint8_t>(solution_.cells[empty[j]] | solution_.cells[empty[j + 1]] << 4);
+    }
+    if (nEmpty % 2 != 0) record[nEmpty / 2] = solution_.cells[empty[nEmpty - 1]];
+
+    blockUsed += recordSize();
+    nSolutions++;
+    return true;
+}
+
+bool SolutionWriter::writeBlock()
+{
+    file.write(block.data(), static_cast<std::streamsize>(blockUsed));
+    blockUsed = 0;
+    return static_cast<bool>(file);
+}
+
+bool SolutionWriter::close()
+{
+    if (!file.is_open()) return false;
+
+    bool written = writeBlock();
+
+    SolutionFileHeader header = makeHeader(puzzle, recordSize(), nSolutions);
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    written = written && static_cast<bool>(file);
+    file.close();
+    return written && !file.fail();
+}
+
+bool SolutionReader::open(const std::string& path_)
+{
+    nSolutions = nRead = 0;
+    if (!hostIsLittleEndian()) return false;
+
+    file.open(path_, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+
+    uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    SolutionFileHeader header;
+    file.seekg(0);
+    if (fileSize < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+
+    for (int i = 0; i < 81; i++) puzzleBoard.cells[i] = static_cast<uint8_t>(i % 2 == 0 ? header.puzzle[i / 2] & 0xF : header.puzzle[i / 2] >> 4);
+    nEmpty = findEmpty(puzzleBoard, empty);
+
+    if (std::memcmp(header.magic, solutionMagic, sizeof(solutionMagic)) != 0 || header.version != solutionVersion ||
+        header.recordSize != (nEmpty + 1) / 2)
+    {
+        file.close();
+        return false;
+    }
+
+    // A solved puzzle has empty records, so only the header can say how many there are
+    nSolutions = header.recordSize > 0 ? (fileSize - sizeof(header)) / header.recordSize : header.nSolutions;
+    return true;
+}
+
+bool SolutionReader::next(Board& solution_)
+{
+    if (nRead == nSolutions) return false;
+
+    uint8_t record[41];
+    if (!file.read(reinterpret_cast<char*>(record), (nEmpty + 1) / 2)) return false;
+
+    solution_ = puzzleBoard;
+    for (int j = 0; j < nEmpty; j++) solution_.cells[empty[j]] = static_cast<uint8_t>(j % 2 == 0 ? record[j / 2] & 0xF : record[j / 2] >> 4);
+
+    nRead++;
+    return true;
+}
@@ -1,756 +1,1045 @@
-/**
-* Author: Ryley Robinson
-* 
-* functions.cpp: Contains definitions for the functions declared in functions.h. Used in Sudoku.cpp.
-*/
-
-#include <vector>
-#include <iostream>
-#include "functions.h"
-
-bool createBoard(int nDigitsToRemove_, int seedBoard_[9][9], int solvedBoard_[9][9], int unsolvedBoard_[9][9])
-{
-    /*
-    * Randomize solved board:
-    *
-    * Swap blocks of three rows/columns to generate a new unique solution.
-    * Swap single rows/ columns within row groups/column groups.
-    */
-
-    // debug
-    std::cout << "\nCreating board..." << std::endl;
-
-    // Decide where to place rows, columns, row groups, and column groups.
-    std::vector<int> unassignedRowGroups;
-    std::vector<int> unassignedColGroups;
-    std::vector<int> unassignedRows;
-    std::vector<int> unassignedCols;
-    for (int n = 0; n < 3; n++)
-    {
-        unassignedRowGroups.push_back(n);
-        unassignedColGroups.push_back(n);
-        unassignedRows.push_back(n);
-        unassignedCols.push_back(n);
-    }
-
-    int assignedRowGroups[3] = {};
-    int assignedColGroups[3] = {};
-    int assignedRows[3] = {};
-    int assignedCols[3] = {};
-
-    for (int n = 0; n < 3; n++)
-    {
-        int index = rand() % (3 - n);
-        assignedRowGroups[n] = unassignedRowGroups[index];
-        unassignedRowGroups.erase(unassignedRowGroups.begin() + (index));
-
-        index = rand() % (3 - n);
-        assignedColGroups[n] = unassignedColGroups[index];
-        unassignedColGroups.erase(unassignedColGroups.begin() + (index));
-
-        index = rand() % (3 - n);
-        assignedRows[n] = unassignedRows[index];
-        unassignedRows.erase(unassignedRows.begin() + (index));
-
-        index = rand() % (3 - n);
-        assignedCols[n] = unassignedCols[index];
-        unassignedCols.erase(unassignedCols.begin() + (index));
-    }
-
-    // Create the solved and unsolved boards from the previous selections.
-    for (int rowGroup = 0; rowGroup < 3; rowGroup++)
-    {
-        for (int colGroup = 0; colGroup < 3; colGroup++)
-        {
-            for (int row = 0; row < 3; row++)
-            {
-                for (int col = 0; col < 3; col++)
-                {
-                    solvedBoard_[row + 3 * rowGroup][col + 3 * colGroup] = seedBoard_[assignedRows[row] + 3 * assignedRowGroups[rowGroup]][assignedCols[col] + 3 * assignedColGroups[colGroup]];
-                    unsolvedBoard_[row + 3 * rowGroup][col + 3 * colGroup] = seedBoard_[assignedRows[row] + 3 * assignedRowGroups[rowGroup]][assignedCols[col] + 3 * assignedColGroups[colGroup]];
-                }
-            }
-        }
-    }
-
-    /*
-    * Remove digits from solved board to create unsolved board:
-    *
-    * Pick an index at random
-    * Check to see if removing it creates an unsolveable board
-    * If so, remove that index from the list of indices available to remove
-    * Otherwise, remove the digit at that index.
-    * Repeat until enough digits have been removed.
-    */
-
-    std::vector<int> indicesAvailable;
-    for (int n = 0; n < 81; n++) indicesAvailable.push_back(n);
-
-    int tempBoard[9][9] = {};
-
-    for (int i = 0; i < nDigitsToRemove_; i++)
-    {
-        bool digitFound = false;
-        while (!digitFound)
-        {
-            // Pick an index at random
-            int tempIndex, indAvailIndex;
-
-            indAvailIndex = rand() % indicesAvailable.size();
-            tempIndex = indicesAvailable[indAvailIndex];
-
-            int tempRow = tempIndex / 9;
-            int tempCol = tempIndex % 9;
-
-            // Remember the old value in case removing it creates multiple solutions
-            int oldValue = unsolvedBoard_[tempRow][tempCol];
-
-            for (int n = 0; n < 81; n++) tempBoard[n / 9][n % 9] = unsolvedBoard_[n / 9][n % 9];
-
-            // Counts how many solutions are possible if we remove the digit at tempRow, tempCol
-            int multipleSolutions = 0;
-
-            for (int n = 1; n < 10; n++)
-            {
-                tempBoard[tempRow][tempCol] = n;
-
-                //Board must not be solveable in more than one way
-                if (sanityCheck(tempBoard) &&
-                    recursiveSolve(tempBoard))
-                {
-                    multipleSolutions++;
-                }
-
-                for (int k = 0; k < 81; k++) tempBoard[k / 9][k % 9] = unsolvedBoard_[k / 9][k % 9];
-            }
-
-            if (multipleSolutions == 1)
-            {
-                unsolvedBoard_[tempRow][tempCol] = 0;
-                digitFound = true;
-            }
-            else if (multipleSolutions == 0)
-            {
-                // debug
-                std::cout << "Something went wrong in board creation. No solution to current board." << std::endl;
-                printBoard(unsolvedBoard_);
-            }
-            else
-            {
-                unsolvedBoard_[tempRow][tempCol] = oldValue;
-            }
-
-            if (indicesAvailable.size() == 1)
-            {
-                // debug
-                std::cout << "No possible digits to remove. Trying board creation again." << std::endl;
-
-                return false;
-            }
-            else
-            {
-                indicesAvailable.erase(indicesAvailable.begin() + indAvailIndex);
-            }
-        }
-
-        printBoard(unsolvedBoard_);
-    }
-
-    return true;
-}
-
-void solveBoard(int board_[9][9])
-{
-    int operationsDone = 1;
-
-    // The working board represents the board like usual, except each space can have more than one possible digit. Helpful for solving algorithm.
-    std::vector<int> workingBoard[9][9];
-
-    // These two for loops assign the known digits, and fill in the possible digits to spaces without known digits
-    for (int i = 0; i < 81; i++)
-    {
-        if (board_[i / 9][i % 9] != 0)
-        {
-            workingBoard[i / 9][i % 9].push_back(board_[i / 9][i % 9]);
-        }
-    }
-
-    for (int i = 0; i < 81; i++)
-    {
-        int row = i / 9, col = i % 9;
-
-        // Find an empty space
-        if (workingBoard[row][col].size() == 0)
-        {
-            // Add all possible digits
-            for (int n = 1; n < 10; n++)
-            {
-                // Check to see if the digit can be added
-                bool digitPossible = true;
-
-                for (int j = 0; j < 9; j++)
-                {
-                    // Row
-                    if (workingBoard[row][j].size() == 1)
-                    {
-                        if (workingBoard[row][j][0] == n)
-                        {
-                            digitPossible = false;
-                        }
-                    }
-
-                    // Column
-                    if (workingBoard[j][col].size() == 1)
-                    {
-                        if (workingBoard[j][col][0] == n)
-                        {
-                            digitPossible = false;
-                        }
-                    }
-
-                    // Square
-                    if (workingBoard[3 * (row / 3) + j / 3][3 * (col / 3) + j % 3].size() == 1)
-                    {
-                        if (workingBoard[3 * (row / 3) + j / 3][3 * (col / 3) + j % 3][0] == n)
-                        {
-                            digitPossible = false;
-                        }
-                    }
-                }
-
-                // If the digit has no apparent contradictions, add it
-                if (digitPossible)
-                {
-                    workingBoard[row][col].push_back(n);
-                }
-            }
-        }
-    }
-
-    // The main solveBoard loop. repeats until no further progress is made
-    while (operationsDone > 0)
-    {
-        operationsDone = 0;
-
-        // Any space with only one possible digit in workingBoard can be added to unsolvedBoard.
-        for (int i = 0; i < 81; i++)
-        {
-            int row = i / 9, col = i % 9;
-
-            if (board_[row][col] == 0 &&
-                workingBoard[row][col].size() == 1)
-            {
-                board_[row][col] = workingBoard[row][col][0];
-            }
-        }
-
-        printBoard(workingBoard);
-
-        // Check each space and remove recorded possibilities that are no longer possible
-        if (operationsDone == 0)
-        {
-            // debug
-            std::cout << "\nRemoving ruled out possibilities." << std::endl;
-
-            for (int i = 0; i < 81; i++)
-            {
-                int row = i / 9, col = i % 9;
-
-                for (int n = workingBoard[row][col].size() - 1; n >= 0; n--)
-                {
-                    bool removeFlag = false;
-
-                    // Find repeat digits
-                    for (int j = 0; j < 9; j++)
-                    {
-                        // Row
-                        if (workingBoard[row][j].size() == 1 &&
-                            j != col)
-                        {
-                            if (workingBoard[row][col][n] == workingBoard[row][j][0])
-                            {
-                                removeFlag = true;
-                            }
-                        }
-
-                        // Column
-                        else if (workingBoard[j][col].size() == 1 &&
-                            j != row)
-                        {
-                            if (workingBoard[row][col][n] == workingBoard[j][col][0])
-                            {
-                                removeFlag = true;
-                            }
-                        }
-
-                        // Square
-                        else if (workingBoard[3 * (row / 3) + j / 3][3 * (col / 3) + j % 3].size() == 1 &&
-                            3 * (row / 3) + j / 3 != row &&
-                            3 * (col / 3) + j % 3 != col)
-                        {
-                            if (workingBoard[row][col][n] == workingBoard[3 * (row / 3) + j / 3][3 * (col / 3) + j % 3][0])
-                            {
-                                removeFlag = true;
-                            }
-                        }
-                    }
-
-                    if (removeFlag &&
-                        workingBoard[row][col].size() > 1)
-                    {
-                        // debug
-                        std::cout << "Removing digit " << workingBoard[row][col][n] << " at " << row << " " << col << " from";
-                        for (int k = 0; k < workingBoard[row][col].size(); k++) std::cout << " " << workingBoard[row][col][k];
-                        std::cout << std::endl;
-
-                        workingBoard[row][col].erase(workingBoard[row][col].begin() + n);
-                        operationsDone++;
-                    }
-                }
-            }
-        }
-
-        // Check each row, column, and square for digits that can only be placed in one space.
-        if (operationsDone == 0)
-        {
-
-            for (int n = 1; n < 10; n++)
-            {
-                for (int i = 0; i < 9; i++)
-                {
-                    struct LastOccurrence
-                    {
-                        int row = -1, col = -1, squ = -1;
-                    };
-
-                    struct NumOccurrences
-                    {
-                        int row = 0, col = 0, squ = 0;
-                    };
-
-                    LastOccurrence lastOccurrence;
-                    NumOccurrences numOccurrences;
-
-                    for (int j = 0; j < 9; j++)
-                    {
-                        // Row occurrences
-                        for (int k = 0; k < workingBoard[i][j].size(); k++)
-                        {
-                            if (workingBoard[i][j][k] == n)
-                            {
-                                lastOccurrence.row = j;
-                                numOccurrences.row++;
-                            }
-                        }
-
-                        // Column occurrences
-                        for (int k = 0; k < workingBoard[j][i].size(); k++)
-                        {
-                            if (workingBoard[j][i][k] == n)
-                            {
-                                lastOccurrence.col = j;
-                                numOccurrences.col++;
-                            }
-                        }
-
-                        // Square occurrences
-                        for (int k = 0; k < workingBoard[3 * (i / 3) + j / 3][3 * (i % 3) + j % 3].size(); k++)
-                        {
-                            if (workingBoard[3 * (i / 3) + j / 3][3 * (i % 3) + j % 3][k] == n)
-                            {
-                                lastOccurrence.squ = j;
-                                numOccurrences.squ++;
-                            }
-                        }
-                    }
-
-                    // If there is only one occurrence of the number, remove the other possibilities from that space.
-                    if (numOccurrences.row == 1 &&
-                        workingBoard[i][lastOccurrence.row].size() > 1)
-                    {
-                        for (int l = 0; l < workingBoard[i][lastOccurrence.row].size(); l++) std::cout << " " << workingBoard[i][lastOccurrence.row][l];
-                        std::cout << std::endl;
-
-                        for (int k = workingBoard[i][lastOccurrence.row].size() - 1; k >= 0; k--)
-                        {
-
-                            if (workingBoard[i][lastOccurrence.row][k] != n)
-                            {
-
-                                workingBoard[i][lastOccurrence.row].erase(workingBoard[i][lastOccurrence.row].begin() + k);
-                                operationsDone++;
-                            }
-                        }
-                    }
-
-                    else if (numOccurrences.col == 1 &&
-                        workingBoard[lastOccurrence.col][i].size() > 1)
-                    {
-                        for (int l = 0; l < workingBoard[lastOccurrence.col][i].size(); l++) std::cout << " " << workingBoard[lastOccurrence.col][i][l];
-                        std::cout << std::endl;
-
-                        for (int k = workingBoard[lastOccurrence.col][i].size() - 1; k >= 0; k--)
-                        {
-                            if (workingBoard[lastOccurrence.col][i][k] != n)
-                            {
-
-                                workingBoard[lastOccurrence.col][i].erase(workingBoard[lastOccurrence.col][i].begin() + k);
-                                operationsDone++;
-                            }
-                        }
-                    }
-
-                    else if (numOccurrences.squ == 1 &&
-                        workingBoard[3 * (i / 3) + lastOccurrence.squ / 3][3 * (i % 3) + lastOccurrence.squ % 3].size() > 1)
-                    {
-                        for (int l = 0; l < workingBoard[3 * (i / 3) + lastOccurrence.squ / 3][3 * (i % 3) + lastOccurrence.squ % 3].size(); l++)
-                            std::cout << " " << workingBoard[3 * (i / 3) + lastOccurrence.squ / 3][3 * (i % 3) + lastOccurrence.squ % 3][l];
-                        std::cout << std::endl;
-
-                        for (int k = workingBoard[3 * (i / 3) + lastOccurrence.squ / 3][3 * (i % 3) + lastOccurrence.squ % 3].size() - 1; k >= 0; k--)
-                        {
-                            if (workingBoard[3 * (i / 3) + lastOccurrence.squ / 3][3 * (i % 3) + lastOccurrence.squ % 3][k] != n)
-                            {
-
-                                workingBoard[3 * (i / 3) + lastOccurrence.squ / 3][3 * (i % 3) + lastOccurrence.squ % 3].erase(
-                                    workingBoard[3 * (i / 3) + lastOccurrence.squ / 3][3 * (i % 3) + lastOccurrence.squ % 3].begin() + k);
-                                operationsDone++;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-
-        // Identify naked pairs. Remove possible digits ruled out by that pair.
-        if (operationsDone == 0)
-        {
-            for (int i = 0; i < 9; i++)
-            {
-                // Search for spaces with only the same two possibilities.
-                for (int j = 0; j < 9; j++)
-                {
-                    struct PairIndices
-                    {
-                        int row[2], col[2], squ[2];
-                    };
-
-                    struct NakedPairFound
-                    {
-                        bool row = false, col = false, squ = false;
-                    };
-
-                    PairIndices pairIndices;
-                    NakedPairFound nakedPairFound;
-
-                    // Rows
-                    if (workingBoard[i][j].size() == 2)
-                    {
-                        // If we find a space with only two possibilities, try to find another.
-                        for (int k = 0; k < 9; k++)
-                        {
-                            if (workingBoard[i][k].size() == 2)
-                            {
-                                // If we find another with the same two possibilities, we've found a naked pair.
-                                if (k != j &&
-                                    workingBoard[i][k][0] == workingBoard[i][j][0] &&
-                                    workingBoard[i][k][1] == workingBoard[i][j][1])
-                                {
-                                    pairIndices.row[0] = j, pairIndices.row[1] = k;
-                                    nakedPairFound.row = true;
-                                }
-                            }
-                        }
-                    }
-
-                    // Columns
-                    if (workingBoard[j][i].size() == 2)
-                    {
-                        // If we find a space with only two possibilities, try to find another.
-                        for (int k = 0; k < 9; k++)
-                        {
-                            if (workingBoard[k][i].size() == 2)
-                            {
-                                // If we find another with the same two possibilities, we've found a naked pair.
-                                if (k != j &&
-                                    workingBoard[k][i][0] == workingBoard[j][i][0] &&
-                                    workingBoard[k][i][1] == workingBoard[j][i][1])
-                                {
-                                    pairIndices.col[0] = j, pairIndices.col[1] = k;
-                                    nakedPairFound.col = true;
-                                }
-                            }
-                        }
-                    }
-
-                    // Squares
-                    if (workingBoard[3 * (i / 3) + j / 3][3 * (i % 3) + j % 3].size() == 2)
-                    {
-                        // If we find a space with only two possibilities, try to find another.
-                        for (int k = 0; k < 9; k++)
-                        {
-                            if (workingBoard[3 * (i / 3) + k / 3][3 * (i % 3) + k % 3].size() == 2)
-                            {
-                                // If we find another with the same two possibilities, we've found a naked pair.
-                                if (k != j &&
-                                    workingBoard[3 * (i / 3) + k / 3][3 * (i % 3) + k % 3][0] == workingBoard[3 * (i / 3) + j / 3][3 * (i % 3) + j % 3][0] &&
-                                    workingBoard[3 * (i / 3) + k / 3][3 * (i % 3) + k % 3][1] == workingBoard[3 * (i / 3) + j / 3][3 * (i % 3) + j % 3][1])
-                                {
-                                    pairIndices.squ[0] = j, pairIndices.squ[1] = k;
-                                    nakedPairFound.squ = true;
-                                }
-                            }
-                        }
-                    }
-
-                    // We can remove possibilities from this row that are eliminated by the naked pair
-                    for (int k = 0; k < 9 && nakedPairFound.row; k++)
-                    {
-                        if (workingBoard[i][k].size() > 1 &&
-                            k != pairIndices.row[0] &&
-                            k != pairIndices.row[1])
-                        {
-                            for (int l = workingBoard[i][k].size() - 1; l >= 0; l--)
-                            {
-                                if (workingBoard[i][k][l] == workingBoard[i][pairIndices.row[0]][0] ||
-                                    workingBoard[i][k][l] == workingBoard[i][pairIndices.row[0]][1])
-                                {
-                                    workingBoard[i][k].erase(workingBoard[i][k].begin() + l);
-                                    operationsDone++;
-                                }
-                            }
-                        }
-                    }
-
-                    // Same for columns
-                    for (int k = 0; k < 9 && nakedPairFound.col; k++)
-                    {
-                        if (workingBoard[k][i].size() > 1 &&
-                            k != pairIndices.col[0] &&
-                            k != pairIndices.col[1])
-                        {
-                            for (int l = workingBoard[k][i].size() - 1; l >= 0; l--)
-                            {
-                                if (workingBoard[k][i][l] == workingBoard[pairIndices.col[0]][i][0] ||
-                                    workingBoard[k][i][l] == workingBoard[pairIndices.col[0]][i][1])
-                                {
-                                    workingBoard[k][i].erase(workingBoard[k][i].begin() + l);
-                                    operationsDone++;
-                                }
-                            }
-                        }
-                    }
-
-                    // Same for squares
-                    for (int k = 0; k < 9 && nakedPairFound.squ; k++)
-                    {
-                        if (workingBoard[3 * (i / 3) + k / 3][3 * (i % 3) + k % 3].size() > 1 &&
-                            k != pairIndices.squ[0] &&
-                            k != pairIndices.squ[1])
-                        {
-                            for (int l = workingBoard[3 * (i / 3) + k / 3][3 * (i % 3) + k % 3].size() - 1; l >= 0; l--)
-                            {
-                                if (workingBoard[3 * (i / 3) + k / 3][3 * (i % 3) + k % 3][l] == workingBoard[3 * (i / 3) + pairIndices.squ[0] / 3][3 * (i % 3) + pairIndices.squ[0] % 3][0] ||
-                                    workingBoard[3 * (i / 3) + k / 3][3 * (i % 3) + k % 3][l] == workingBoard[3 * (i / 3) + pairIndices.squ[0] / 3][3 * (i % 3) + pairIndices.squ[0] % 3][1])
-                                {
-                                    workingBoard[3 * (i / 3) + k / 3][3 * (i % 3) + k % 3].erase(workingBoard[3 * (i / 3) + k / 3][3 * (i % 3) + k % 3].begin() + l);
-                                    operationsDone++;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-
-        // Identify hidden pairs. Remove possible digits ruled out by that pair.
-    }
-}
-
-bool recursiveSolve(int board_[9][9])
-{
-    /*
-    * Algorithm pseudocode:
-    * - Find an empty space
-    * - Assign it a digit
-    * - Check to see if this creates a contradiction
-    *   - If yes, assign a new digit
-    *     - If no more digits, return
-    *   - If no, repeat function recursively
-    */
-
-    // Find an empty space on the board,
-    int i = -1;
-    do
-    {
-        i++;
-        if (i > 80) return true;
-    } while (board_[i / 9][i % 9] != 0);
-    int row = i / 9, col = i % 9;
-
-    // For each possible digit,
-    for (int n = 1; n < 10; n++)
-    {
-        bool contradictionFound = false;
-
-        // check for contradictions.
-        for (int j = 0; j < 9 && !contradictionFound; j++)
-        {
-            if (board_[row][j] == n) contradictionFound = true;
-
-            else if (board_[j][col] == n) contradictionFound = true;
-
-            else if (board_[3 * (row / 3) + j / 3][3 * (col / 3) + j % 3] == n) contradictionFound = true;
-        }
-
-        // If it doesn't create a contradiction,
-        if (!contradictionFound)
-        {
-            // place that digit,
-            board_[row][col] = n;
-
-            // otherwise find the next digit to place.
-            if (recursiveSolve(board_))
-            {
-                return true;
-            }
-            else
-            {
-                board_[row][col] = 0;
-            }
-        }
-    }
-
-    // If there are no more digits to place, and the board isn't solved, something went wrong.
-    return false;
-}
-
-bool checkSolution(int solvedBoard_[9][9], int unsolvedBoard_[9][9])
-{
-    /*
-    * Checks to see that the solution is correct.
-    *
-    * Go through each row and column and see if the digit matches the solvedBoard digit.
-    * Go through each row, column, and square and see if there are any inconsistencies.
-    */
-    for (int row = 0; row < 9; row++)
-    {
-        for (int col = 0; col < 9; col++)
-        {
-            if (solvedBoard_[row][col] != unsolvedBoard_[row][col])
-            {
-                return false;
-            }
-        }
-    }
-    return true;
-}
-
-bool sanityCheck(int board_[9][9])
-{
-    // Check for duplicates of each number in each row, column, and square. Does not consider 0 to be a duplicate.
-
-    for (int i = 0; i < 9; i++)
-    {
-        for (int n = 1; n < 10; n++)
-        {
-            int count[3] = { 0, 0, 0 };
-
-            for (int j = 0; j < 9; j++)
-            {
-                if (board_[i][j] == n)
-                {
-                    count[0]++;
-                }
-                if (board_[j][i] == n)
-                {
-                    count[1]++;
-                }
-                if (board_[3 * (i % 3) + j / 3][3 * (i / 3) + j % 3] == n)
-                {
-                    count[2]++;
-                }
-            }
-
-            if (count[0] > 1 || count[1] > 1 || count[2] > 1)
-            {
-                return false;
-            }
-        }
-    }
-
-    return true;
-}
-
-void printBoard(int board_[9][9])
-{
-    std::cout << std::endl;
-    for (int row = 0; row < 9; row++)
-    {
-        if (row == 3 || row == 6)
-        {
-            std::cout << " ------+-------+------" << std::endl;
-        }
-        for (int col = 0; col < 9; col++)
-        {
-            if (col == 3 || col == 6)
-            {
-                std::cout << " |";
-            }
-            if (board_[row][col] == 0)
-            {
-                std::cout << " -";
-            }
-            else
-            {
-                std::cout << " " << board_[row][col];
-            }
-        }
-
-        std::cout << std::endl;
-    }
-}
-
-void printBoard(std::vector<int> board_[9][9])
-{
-    std::cout << std::endl;
-    for (int row = 0; row < 9; row++)
-    {
-        if (row == 3 || row == 6)
-        {
-            std::cout << " ------------------------------+------------------------------+------------------------------" << std::endl;
-        }
-        for (int col = 0; col < 9; col++)
-        {
-            if (col == 3 || col == 6)
-            {
-                std::cout << " |";
-            }
-            if (board_[row][col].size() == 0)
-            {
-                std::cout << " -  ";
-            }
-            else
-            {
-                std::cout << " ";
-                for (int k = 0; k < 9; k++)
-                {
-                    if (k < board_[row][col].size()) std::cout << board_[row][col][k];
-
-                    else std::cout << " ";
-                }
-            }
-        }
-
-        std::cout << std::endl;
-    }
-}
-
-bool runAgainCheck()
-{
-    std::string userInput;
-    std::cout << "\nEnter \"quit\" to end program, or anything else to run again." << std::endl;
-    std::cin >> userInput;
-
-    return userInput == "quit" ? false : true;
+/**
+* Author: Ryley Robinson
+* 
+* functions.cpp: Contains definitions for the functions declared in functions.h. Used in Sudoku.cpp.
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "functions.h"
+#include "stats.h"
+#include "trace.h"
+
+namespace
+{
+    // Lists the digits in a mask, for tracing
+    std::string maskDigits(Cand::Mask mask_)
+    {
+        std::string digits;
+        for (int n = 1; n < 10; n++)
+        {
+            if (mask_ & Cand::digitMask(n)) digits += static_cast<char>('0' + n);
+        }
+        return digits;
+    }
+}
+
+bool createBoard(int nDigitsToRemove_, int seedBoard_[9][9], int solvedBoard_[9][9], int unsolvedBoard_[9][9], SolverBackend backend_)
+{
+    // Seed a private generator from rand(), so that callers relying on srand() still get a reproducible sequence.
+    Rng rng(static_cast<uint64_t>(rand()));
+    return createBoard(nDigitsToRemove_, seedBoard_, solvedBoard_, unsolvedBoard_, rng, backend_);
+}
+
+bool createBoard(int nDigitsToRemove_, int seedBoard_[9][9], int solvedBoard_[9][9], int unsolvedBoard_[9][9], Rng& rng_, SolverBackend backend_)
+{
+    return createGrid<3>(nDigitsToRemove_, seedBoard_, solvedBoard_, unsolvedBoard_, rng_, backend_);
+}
+
+bool createBoard(int nDigitsToRemove_, const Board& seedBoard_, Board& solvedBoard_, Board& unsolvedBoard_, SolverBackend backend_)
+{
+    Rng rng(static_cast<uint64_t>(rand()));
+    return createBoard(nDigitsToRemove_, seedBoard_, solvedBoard_, unsolvedBoard_, rng, backend_);
+}
+
+bool createBoard(int nDigitsToRemove_, const Board& seedBoard_, Board& solvedBoard_, Board& unsolvedBoard_, Rng& rng_, SolverBackend backend_)
+{
+    // The generator is shared with the larger boards, so it works on ints. The boards are converted once each way.
+    int seedBoard[9][9], solvedBoard[9][9], unsolvedBoard[9][9];
+    seedBoard_.store(seedBoard);
+
+    bool created = createGrid<3>(nDigitsToRemove_, seedBoard, solvedBoard, unsolvedBoard, rng_, backend_);
+    solvedBoard_.load(solvedBoard);
+    unsolvedBoard_.load(unsolvedBoard);
+    return created;
+}
+
+namespace
+{
+    // Puts the first count_ values in a uniformly random order
+    void shuffle(int* values_, int count_, Rng& rng_)
+    {
+        for (int n = count_ - 1; n > 0; n--)
+        {
+            int k = rng_.below(n + 1);
+            int value = values_[n];
+            values_[n] = values_[k];
+            values_[k] = value;
+        }
+    }
+
+    /*
+    * Randomize solved board, with a transformation drawn uniformly from the group that preserves sudoku-validity:
+    *
+    * Reorder the bands of Box rows, and the rows inside each band independently. The same for stacks of columns.
+    * Transpose the board half of the time.
+    * Relabel the digits.
+    *
+    * The transformation is collected into index tables first, and then applied in a single pass over the board.
+    * The result is written to both boards.
+    */
+    template <int Box>
+    void randomizeGrid(int seedBoard_[Box * Box][Box * Box], int solvedBoard_[Box * Box][Box * Box], int unsolvedBoard_[Box * Box][Box * Box], Rng& rng_)
+    {
+        const int size = Box * Box, cells = size * size;
+
+        // Decide which row and column of the seed board each row and column is taken from.
+        int bands[Box], stacks[Box], rowMap[size], colMap[size];
+        for (int n = 0; n < Box; n++) bands[n] = stacks[n] = n;
+        shuffle(bands, Box, rng_);
+        shuffle(stacks, Box, rng_);
+
+        for (int group = 0; group < Box; group++)
+        {
+            int rows[Box], cols[Box];
+            for (int n = 0; n < Box; n++) rows[n] = cols[n] = n;
+            shuffle(rows, Box, rng_);
+            shuffle(cols, Box, rng_);
+
+            for (int n = 0; n < Box; n++)
+            {
+                rowMap[Box * group + n] = Box * bands[group] + rows[n];
+                colMap[Box * group + n] = Box * stacks[group] + cols[n];
+            }
+        }
+
+        bool transpose = rng_.below(2) == 1;
+
+        // digitMap[n] is the digit that replaces n. Empty spaces stay empty.
+        int digitMap[size + 1];
+        for (int n = 0; n <= size; n++) digitMap[n] = n;
+        shuffle(digitMap + 1, size, rng_);
+
+        // Create the solved and unsolved boards from the previous selections.
+        int* seed = &seedBoard_[0][0];
+        for (int i = 0; i < cells; i++)
+        {
+            int row = rowMap[i / size], col = colMap[i % size];
+            int n = digitMap[transpose ? seed[size * col + row] : seed[size * row + col]];
+
+            solvedBoard_[i / size][i % size] = n;
+            unsolvedBoard_[i / size][i % size] = n;
+        }
+    }
+
+    // Counts up to limit_ solutions. Only 9 x 9 boards have a choice of backend.
+    template <int Box>
+    int countForGenerator(int board_[Box * Box][Box * Box], int limit_, SolverBackend backend_)
+    {
+        if constexpr (Box == 3) return exactCountSolutions(board_, limit_, backend_);
+        else return countGridSolutions<Box>(board_, limit_);
+    }
+}
+
+template <int Box>
+bool createGrid(int nDigitsToRemove_, int seedBoard_[Box * Box][Box * Box], int solvedBoard_[Box * Box][Box * Box], int unsolvedBoard_[Box * Box][Box * Box], Rng& rng_, SolverBackend backend_)
+{
+    const int size = Box * Box, cells = size * size;
+    Stats::Timer timer(Stats::Phase::CreateBoard);
+
+    TRACE("\nCreating board...");
+
+    {
+        Stats::Timer randomizeTimer(Stats::Phase::Randomize);
+        randomizeGrid<Box>(seedBoard_, solvedBoard_, unsolvedBoard_, rng_);
+    }
+
+    /*
+    * Remove digits from solved board to create unsolved board:
+    *
+    * Pick an index at random
+    * Check to see if removing it creates a board with more than one solution
+    * If so, remove that index from the list of indices available to remove
+    * Otherwise, remove the digit at that index.
+    * Repeat until enough digits have been removed.
+    */
+
+    int indicesAvailable[cells];
+    int nIndicesAvailable = cells;
+    for (int n = 0; n < cells; n++) indicesAvailable[n] = n;
+
+    // The search keeps its state from one removal to the next. Dancing links checks each board from scratch.
+    const bool incremental = Box != 3 || backend_ == SolverBackend::Search;
+    Stats::Timer removeTimer(Stats::Phase::RemoveDigits);
+    BasicRemovalState<Box> removalState;
+    if (incremental) removalState.load(solvedBoard_);
+
+    for (int i = 0; i < nDigitsToRemove_; i++)
+    {
+        bool digitFound = false;
+        while (!digitFound)
+        {
+            // Pick an index at random
+            int tempIndex, indAvailIndex;
+
+            indAvailIndex = rng_.below(nIndicesAvailable);
+            tempIndex = indicesAvailable[indAvailIndex];
+
+            int tempRow = tempIndex / size;
+            int tempCol = tempIndex % size;
+
+            Stats::count(Stats::Counter::RemovalAttempts);
+            Stats::Timer checkTimer(Stats::Phase::UniquenessCheck);
+
+            // Board must not be solveable in more than one way.
+            if (incremental)
+            {
+                digitFound = removalState.tryRemove(tempIndex);
+                if (digitFound) unsolvedBoard_[tempRow][tempCol] = 0;
+            }
+            else
+            {
+                // Remember the old value in case removing it creates multiple solutions
+                int oldValue = unsolvedBoard_[tempRow][tempCol];
+                unsolvedBoard_[tempRow][tempCol] = 0;
+
+                // A single search that stops at the second solution is enough to tell.
+                int nSolutions = countForGenerator<Box>(unsolvedBoard_, 2, backend_);
+
+                if (nSolutions == 1)
+                {
+                    digitFound = true;
+                }
+                else if (nSolutions == 0)
+                {
+                    TRACE("Something went wrong in board creation. No solution to current board.");
+                    TRACE_GRID(Box, unsolvedBoard_);
+                    unsolvedBoard_[tempRow][tempCol] = oldValue;
+                }
+                else
+                {
+                    unsolvedBoard_[tempRow][tempCol] = oldValue;
+                }
+            }
+
+            if (!digitFound) Stats::count(Stats::Counter::RemovalsRejected);
+
+            if (nIndicesAvailable == 1)
+            {
+                TRACE("No possible digits to remove. Trying board creation again.");
+
+                Stats::count(Stats::Counter::CreateRetries);
+                return false;
+            }
+            else
+            {
+                // The order of the indices left doesn't matter, since the next one is picked at random
+                indicesAvailable[indAvailIndex] = indicesAvailable[--nIndicesAvailable];
+            }
+        }
+
+        TRACE_GRID(Box, unsolvedBoard_);
+    }
+
+    Stats::count(Stats::Counter::BoardsCreated);
+    return true;
+}
+
+template <int Box>
+bool generateGrid(int nClues_, int seedBoard_[Box * Box][Box * Box], int solvedBoard_[Box * Box][Box * Box], int unsolvedBoard_[Box * Box][Box * Box], Rng& rng_, GenerateReport* report_)
+{
+    const int size = Box * Box, cells = size * size;
+
+    // Backtracks allowed on one solved board before drawing a new one, and new boards drawn before giving up
+    const int maxBacktracks = 32;
+    const int maxRestarts = 1000;
+
+    /*
+    * Remove digits until nClues_ remain:
+    *
+    * Try to remove every given digit once, in a random order. Whatever is left when that pass is over is a minimal
+    * puzzle: no digit could be removed then, and removing more digits only ever adds solutions.
+    * If that leaves more than nClues_ digits, put back the most recently removed digits and run another pass in a
+    * new order. Put back more digits each time this happens on the same board.
+    * Draw a new solved board if too many passes fail.
+    */
+
+    GenerateReport report;
+    auto start = std::chrono::steady_clock::now();
+
+    BasicRemovalState<Box> removalState;
+    int removed[cells];
+    int nRemoved = 0, nBacktracks = 0;
+    bool newBoard = true;
+
+    TRACE("\nGenerating a board with " << nClues_ << " clues...");
+
+    while (true)
+    {
+        if (newBoard)
+        {
+            if (report.nRestarts > maxRestarts) break;
+
+            randomizeGrid<Box>(seedBoard_, solvedBoard_, unsolvedBoard_, rng_);
+            removalState.load(solvedBoard_);
+            nRemoved = nBacktracks = 0;
+            newBoard = false;
+        }
+
+        int order[cells];
+        int nOrder = 0;
+        for (int i = 0; i < cells; i++)
+        {
+            if (removalState.givens.digits[i] != 0) order[nOrder++] = i;
+        }
+        shuffle(order, nOrder, rng_);
+
+        for (int k = 0; k < nOrder && cells - nRemoved > nClues_; k++)
+        {
+            report.nAttempts++;
+            if (removalState.tryRemove(order[k]))
+            {
+                unsolvedBoard_[order[k] / size][order[k] % size] = 0;
+                removed[nRemoved++] = order[k];
+            }
+        }
+
+        if (cells - nRemoved <= nClues_ || nClues_ <= 0) break;
+
+        TRACE("Stuck at " << cells - nRemoved << " clues. Putting back the last " << nBacktracks + 1 << " removed digits.");
+
+        report.nBacktracks++;
+        if (++nBacktracks > maxBacktracks || nBacktracks > nRemoved)
+        {
+            report.nRestarts++;
+            newBoard = true;
+            continue;
+        }
+
+        for (int k = 0; k < nBacktracks; k++)
+        {
+            int index = removed[--nRemoved];
+            removalState.restore(index, solvedBoard_[index / size][index % size]);
+            unsolvedBoard_[index / size][index % size] = solvedBoard_[index / size][index % size];
+        }
+    }
+
+    TRACE_GRID(Box, unsolvedBoard_);
+
+    report.nClues = cells - nRemoved;
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (report_) *report_ = report;
+
+    return nClues_ <= 0 || report.nClues <= nClues_;
+}
+
+bool generateForDifficulty(int minScore_, int maxScore_, int seedBoard_[9][9], int solvedBoard_[9][9], int unsolvedBoard_[9][9], Rng& rng_, GenerateReport* report_, GradeReport* grade_)
+{
+    // Boards with more clues than this are always easy, so they aren't graded
+    const int maxGradedClues = 36;
+    const int maxRestarts = 1000;
+
+    /*
+    * Remove digits one at a time in a random order, and grade the board after each removal:
+    *
+    * If it is too easy, keep removing digits.
+    * If it is too hard, put the digit back and try the next one. Grading stops as soon as the score passes maxScore_.
+    * If it is in range, it's done.
+    * Draw a new solved board if no digit is left to try.
+    */
+
+    GenerateReport report;
+    GradeReport grade;
+    auto start = std::chrono::steady_clock::now();
+    bool found = false;
+    int nClues = 81;
+
+    RemovalState removalState;
+
+    TRACE("\nGenerating a board with a score from " << minScore_ << " to " << maxScore_ << "...");
+
+    for (; !found && report.nRestarts <= maxRestarts; report.nRestarts++)
+    {
+        randomizeGrid<3>(seedBoard_, solvedBoard_, unsolvedBoard_, rng_);
+        removalState.load(solvedBoard_);
+
+        int order[81];
+        for (int i = 0; i < 81; i++) order[i] = i;
+        shuffle(order, 81, rng_);
+
+        nClues = 81;
+        for (int k = 0; k < 81 && !found; k++)
+        {
+            int row = order[k] / 9, col = order[k] % 9;
+
+            report.nAttempts++;
+            if (!removalState.tryRemove(order[k])) continue;
+
+            unsolvedBoard_[row][col] = 0;
+            nClues--;
+            if (nClues > maxGradedClues) continue;
+
+            report.nGraded++;
+            int score = gradeBoard(unsolvedBoard_, &grade, maxScore_);
+
+            if (grade.aborted)
+            {
+                removalState.restore(order[k], solvedBoard_[row][col]);
+                unsolvedBoard_[row][col] = solvedBoard_[row][col];
+                nClues++;
+            }
+            else if (score >= minScore_)
+            {
+                found = true;
+            }
+        }
+    }
+
+    if (found) report.nRestarts--;
+    report.nClues = nClues;
+
+    TRACE_BOARD(unsolvedBoard_);
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (report_) *report_ = report;
+    if (grade_) *grade_ = grade;
+
+    return found;
+}
+
+template <int Box>
+void patternGrid(int board_[Box * Box][Box * Box])
+{
+    const int size = Box * Box;
+
+    // Each row is the one above shifted by a whole square, and each band starts one digit further along.
+    for (int row = 0; row < size; row++)
+    {
+        for (int col = 0; col < size; col++)
+        {
+            board_[row][col] = (Box * (row % Box) + row / Box + col) % size + 1;
+        }
+    }
+}
+
+template bool createGrid<3>(int nDigitsToRemove_, int seedBoard_[9][9], int solvedBoard_[9][9], int unsolvedBoard_[9][9], Rng& rng_, SolverBackend backend_);
+template bool createGrid<4>(int nDigitsToRemove_, int seedBoard_[16][16], int solvedBoard_[16][16], int unsolvedBoard_[16][16], Rng& rng_, SolverBackend backend_);
+template bool createGrid<5>(int nDigitsToRemove_, int seedBoard_[25][25], int solvedBoard_[25][25], int unsolvedBoard_[25][25], Rng& rng_, SolverBackend backend_);
+
+template bool generateGrid<3>(int nClues_, int seedBoard_[9][9], int solvedBoard_[9][9], int unsolvedBoard_[9][9], Rng& rng_, GenerateReport* report_);
+template bool generateGrid<4>(int nClues_, int seedBoard_[16][16], int solvedBoard_[16][16], int unsolvedBoard_[16][16], Rng& rng_, GenerateReport* report_);
+template bool generateGrid<5>(int nClues_, int seedBoard_[25][25], int solvedBoard_[25][25], int unsolvedBoard_[25][25], Rng& rng_, GenerateReport* report_);
+
+template void patternGrid<3>(int board_[9][9]);
+template void patternGrid<4>(int board_[16][16]);
+template void patternGrid<5>(int board_[25][25]);
+
+void solveBoard(Board& board_)
+{
+    int board[9][9];
+    board_.store(board);
+    solveBoard(board);
+    board_.load(board);
+}
+
+void solveBoard(int board_[9][9])
+{
+    Stats::Timer timer(Stats::Phase::SolveBoard);
+    Stats::count(Stats::Counter::BoardsSolved);
+
+    applyTechniques(board_);
+
+    // If the human methods make no more progress, finish the puzzle off with the backtracking search.
+    for (int i = 0; i < 81; i++)
+    {
+        if (board_[i / 9][i % 9] == 0)
+        {
+            TRACE("\nNo further progress. Falling back to backtracking search.");
+
+            Stats::count(Stats::Counter::SearchFallbacks);
+            Stats::Timer searchTimer(Stats::Phase::Search);
+            searchSolve(board_);
+            break;
+        }
+    }
+}
+
+int placeSingles(CandidateBoard& workingBoard_, int board_[9][9])
+{
+    int nPlaced = 0;
+
+    for (int i = 0; i < 81; i++)
+    {
+        int row = i / 9, col = i % 9;
+
+        if (board_[row][col] == 0 &&
+            Cand::countDigits(workingBoard_.cells[i]) == 1)
+        {
+            board_[row][col] = Cand::firstDigit(workingBoard_.cells[i]);
+            workingBoard_.markSolved(i);
+            nPlaced++;
+        }
+    }
+
+    return nPlaced;
+}
+
+int removeRuledOut(CandidateBoard& workingBoard_)
+{
+    // Check each space and remove recorded possibilities that are no longer possible
+    int nRemoved = 0;
+
+    TRACE("\nRemoving ruled out possibilities.");
+
+    for (int i = 0; i < 81; i++)
+    {
+        Cand::Mask possible = workingBoard_.cells[i];
+        Cand::Mask remaining = possible & ~workingBoard_.used(i);
+
+        if (Cand::countDigits(possible) > 1 &&
+            remaining != possible &&
+            remaining != 0)
+        {
+            TRACE("Removing digits at " << i / 9 << " " << i % 9 << " from " << maskDigits(possible) << " to " << maskDigits(remaining));
+
+            workingBoard_.cells[i] = remaining;
+            nRemoved += Cand::countDigits(possible & ~remaining);
+        }
+    }
+
+    return nRemoved;
+}
+
+int findHiddenSingles(CandidateBoard& workingBoard_)
+{
+    // Check each row, column, and square for digits that can only be placed in one space.
+    int nRemoved = 0;
+
+    for (int unit = 0; unit < 27; unit++)
+    {
+        // Bit-sliced count of each digit's occurrences: once holds digits seen at least once, twice at least twice.
+        Cand::Mask once = 0, twice = 0;
+
+        for (int j = 0; j < 9; j++)
+        {
+            Cand::Mask possible = workingBoard_.cells[Cand::units.unitCells[unit][j]];
+            twice |= once & possible;
+            once |= possible;
+        }
+
+        Cand::Mask hidden = once & ~twice;
+
+        // If there is only one occurrence of the number, remove the other possibilities from that space.
+        for (int j = 0; j < 9 && hidden != 0; j++)
+        {
+            int index = Cand::units.unitCells[unit][j];
+            Cand::Mask possible = workingBoard_.cells[index];
+
+            if (Cand::countDigits(possible) > 1 &&
+                Cand::countDigits(possible & hidden) == 1)
+            {
+                workingBoard_.cells[index] = possible & hidden;
+                nRemoved += Cand::countDigits(possible) - 1;
+            }
+        }
+    }
+
+    return nRemoved;
+}
+
+int findNakedPairs(CandidateBoard& workingBoard_)
+{
+    // Identify naked pairs. Remove possible digits ruled out by that pair.
+    int nRemoved = 0;
+
+    for (int unit = 0; unit < 27; unit++)
+    {
+        const uint8_t* cells = Cand::units.unitCells[unit];
+
+        // Search for spaces with only the same two possibilities.
+        for (int j = 0; j < 9; j++)
+        {
+            Cand::Mask pair = workingBoard_.cells[cells[j]];
+            if (Cand::countDigits(pair) != 2) continue;
+
+            for (int k = j + 1; k < 9; k++)
+            {
+                if (workingBoard_.cells[cells[k]] != pair) continue;
+
+                // We can remove possibilities from this unit that are eliminated by the naked pair
+                for (int l = 0; l < 9; l++)
+                {
+                    Cand::Mask possible = workingBoard_.cells[cells[l]];
+
+                    if (l != j &&
+                        l != k &&
+                        Cand::countDigits(possible) > 1 &&
+                        (possible & pair) != 0 &&
+                        (possible & ~pair) != 0)
+                    {
+                        workingBoard_.cells[cells[l]] = possible & ~pair;
+                        nRemoved += Cand::countDigits(possible & pair);
+                    }
+                }
+            }
+        }
+    }
+
+    return nRemoved;
+}
+
+int findHiddenPairs(CandidateBoard& workingBoard_)
+{
+    // Identify hidden pairs. Remove every other possible digit from the two spaces of the pair.
+    int nRemoved = 0;
+
+    for (int unit = 0; unit < 27; unit++)
+    {
+        const uint8_t* cells = Cand::units.unitCells[unit];
+
+        // Spaces of the unit where each digit is possible, one bit per space
+        uint16_t places[10] = {};
+        for (int j = 0; j < 9; j++)
+        {
+            Cand::Mask possible = workingBoard_.cells[cells[j]];
+            for (int n = 1; n < 10; n++)
+            {
+                if (possible & Cand::digitMask(n)) places[n] |= static_cast<uint16_t>(1 << j);
+            }
+        }
+
+        // Two digits that are only possible in the same two spaces
+        for (int n = 1; n < 10; n++)
+        {
+            if (Cand::countDigits(places[n]) != 2) continue;
+
+            for (int m = n + 1; m < 10; m++)
+            {
+                if (places[m] != places[n]) continue;
+
+                Cand::Mask pair = Cand::digitMask(n) | Cand::digitMask(m);
+                for (int j = 0; j < 9; j++)
+                {
+                    Cand::Mask possible = workingBoard_.cells[cells[j]];
+                    if ((places[n] & (1 << j)) != 0 && possible != pair)
+                    {
+                        workingBoard_.cells[cells[j]] = possible & pair;
+                        nRemoved += Cand::countDigits(possible & ~pair);
+                    }
+                }
+            }
+        }
+    }
+
+    return nRemoved;
+}
+
+namespace
+{
+    // Digits possible in any of the listed spaces, including solved ones
+    Cand::Mask unionOf(const CandidateBoard& workingBoard_, const int* cells_, int nCells_)
+    {
+        Cand::Mask possible = 0;
+        for (int j = 0; j < nCells_; j++) possible |= workingBoard_.cells[cells_[j]];
+        return possible;
+    }
+
+    // Removes digits_ from every unsolved space listed. Returns how many possible digits were removed.
+    int removeFrom(CandidateBoard& workingBoard_, const int* cells_, int nCells_, Cand::Mask digits_)
+    {
+        int nRemoved = 0;
+        for (int j = 0; j < nCells_; j++)
+        {
+            Cand::Mask possible = workingBoard_.cells[cells_[j]];
+            if (Cand::countDigits(possible) > 1 && (possible & digits_) != 0 && (possible & ~digits_) != 0)
+            {
+                workingBoard_.cells[cells_[j]] = possible & ~digits_;
+                nRemoved += Cand::countDigits(possible & digits_);
+            }
+        }
+        return nRemoved;
+    }
+
+    /*
+    * Where a square and a row or column cross, a digit the square can only hold in the crossing must be placed there,
+    * so it can be removed from the rest of the line (pointing pairs). When the line can only hold a digit in the
+    * crossing, it can be removed from the rest of the square instead (box-line reduction).
+    */
+    int reduceIntersections(CandidateBoard& workingBoard_, bool pointing_)
+    {
+        int nRemoved = 0;
+
+        for (int square = 18; square < 27; square++)
+        {
+            const uint8_t* squareCells = Cand::units.unitCells[square];
+
+            // Lines crossing the square: the rows and columns of its first, middle and last spaces
+            for (int k = 0; k < 6; k++)
+            {
+                int line = Cand::units.cellUnits[squareCells[(k % 3) * 4]][k / 3];
+                const uint8_t* lineCells = Cand::units.unitCells[line];
+
+                int squareRest[6], lineRest[6];
+                int nSquareRest = 0, nLineRest = 0;
+                Cand::Mask crossing = 0;
+
+                for (int j = 0; j < 9; j++)
+                {
+                    int index = squareCells[j];
+                    if (Cand::units.cellUnits[index][k / 3] == line) crossing |= workingBoard_.cells[index];
+                    else squareRest[nSquareRest++] = index;
+
+                    if (Cand::units.cellUnits[lineCells[j]][2] != square) lineRest[nLineRest++] = lineCells[j];
+                }
+
+                if (pointing_)
+                {
+                    Cand::Mask digits = crossing & ~unionOf(workingBoard_, squareRest, 6);
+                    if (digits != 0) nRemoved += removeFrom(workingBoard_, lineRest, 6, digits);
+                }
+                else
+                {
+                    Cand::Mask digits = crossing & ~unionOf(workingBoard_, lineRest, 6);
+                    if (digits != 0) nRemoved += removeFrom(workingBoard_, squareRest, 6, digits);
+                }
+            }
+        }
+
+        return nRemoved;
+    }
+
+    /*
+    * Fish of size_ (2 for an X-Wing, 3 for a Swordfish): size_ rows whose places for a digit all fall in the same size_
+    * columns. Each row needs the digit somewhere, so together they fill those columns, and no other row can have the
+    * digit in them. The same holds with rows and columns swapped.
+    */
+    int findFish(CandidateBoard& workingBoard_, int size_)
+    {
+        int nRemoved = 0;
+
+        for (int n = 1; n < 10; n++)
+        {
+            Cand::Mask bit = Cand::digitMask(n);
+
+            // Base units are rows (0-8) and then columns (9-17). The cover units cross them at each position.
+            for (int base = 0; base < 18; base += 9)
+            {
+                int cover = base == 0 ? 9 : 0;
+
+                // Positions in each base unit where the digit is still open. Units where it is solved are left out.
+                uint16_t places[9];
+                for (int u = 0; u < 9; u++)
+                {
+                    places[u] = 0;
+                    const uint8_t* cells = Cand::units.unitCells[base + u];
+
+                    for (int j = 0; j < 9; j++)
+                    {
+                        Cand::Mask possible = workingBoard_.cells[cells[j]];
+                        if (possible == bit)
+                        {
+                            places[u] = 0;
+                            break;
+                        }
+                        if (possible & bit) places[u] |= static_cast<uint16_t>(1 << j);
+                    }
+
+                    if (Cand::countDigits(places[u]) < 2 || Cand::countDigits(places[u]) > size_) places[u] = 0;
+                }
+
+                // Only units with 2 to size_ places can be part of the fish
+                int open[9];
+                int nOpen = 0;
+                for (int u = 0; u < 9; u++)
+                {
+                    if (places[u] != 0) open[nOpen++] = u;
+                }
+
+                // Every choice of size_ of those units, as positions in open[] counting up like an odometer
+                int pick[3] = { 0, 1, 2 };
+                while (nOpen >= size_)
+                {
+                    uint16_t covered = 0, chosen = 0;
+                    for (int p = 0; p < size_; p++)
+                    {
+                        covered |= places[open[pick[p]]];
+                        chosen |= static_cast<uint16_t>(1 << open[pick[p]]);
+                    }
+
+                    if (Cand::countDigits(covered) == size_)
+                    {
+                        for (int j = 0; j < 9; j++)
+                        {
+                            if ((covered & (1 << j)) == 0) continue;
+
+                            int others[9];
+                            int nOthers = 0;
+                            const uint8_t* cells = Cand::units.unitCells[cover + j];
+                            for (int u = 0; u < 9; u++)
+                            {
+                                if ((chosen & (1 << u)) == 0) others[nOthers++] = cells[u];
+                            }
+
+                            nRemoved += removeFrom(workingBoard_, others, nOthers, bit);
+                        }
+                    }
+
+                    // Next choice
+                    int p = size_ - 1;
+                    while (p >= 0 && pick[p] == nOpen - size_ + p) p--;
+                    if (p < 0) break;
+                    pick[p]++;
+                    for (int q = p + 1; q < size_; q++) pick[q] = pick[q - 1] + 1;
+                }
+            }
+        }
+
+        return nRemoved;
+    }
+}
+
+int findPointingPairs(CandidateBoard& workingBoard_)
+{
+    return reduceIntersections(workingBoard_, true);
+}
+
+int findBoxLineReductions(CandidateBoard& workingBoard_)
+{
+    return reduceIntersections(workingBoard_, false);
+}
+
+int findXWings(CandidateBoard& workingBoard_)
+{
+    return findFish(workingBoard_, 2);
+}
+
+int findSwordfish(CandidateBoard& workingBoard_)
+{
+    return findFish(workingBoard_, 3);
+}
+
+bool recursiveSolve(Board& board_, SearchStats* stats_)
+{
+    /*
+    * Algorithm pseudocode:
+    * - Find an empty space
+    * - Assign it a digit
+    * - Check to see if this creates a contradiction
+    *   - If yes, assign a new digit
+    *     - If no more digits, return
+    *   - If no, repeat function recursively
+    */
+
+    if (stats_) stats_->nodesVisited++;
+
+    // Find an empty space on the board,
+    int i = 0;
+    while (board_.cells[i] != 0)
+    {
+        i++;
+        if (i > 80) return true;
+    }
+
+    // collect the digits that would create a contradiction there,
+    const uint8_t* peers = BoardIndex::units.peers[i];
+    unsigned int used = 0;
+    for (int p = 0; p < Grid::Traits<3>::peers; p++) used |= 1u << board_.cells[peers[p]];
+
+    // and try each of the others.
+    for (int n = 1; n < 10; n++)
+    {
+        if (used & (1u << n)) continue;
+
+        // Place that digit, and find the next digit to place.
+        board_.cells[i] = static_cast<uint8_t>(n);
+        if (recursiveSolve(board_, stats_)) return true;
+    }
+
+    // If there are no more digits to place, and the board isn't solved, something went wrong.
+    board_.cells[i] = 0;
+    return false;
+}
+
+bool recursiveSolve(int board_[9][9], SearchStats* stats_)
+{
+    Board board;
+    board.load(board_);
+
+    bool solved = recursiveSolve(board, stats_);
+    board.store(board_);
+    return solved;
+}
+
+bool exactSolve(int board_[9][9], SolverBackend backend_, SearchStats* stats_)
+{
+    return backend_ == SolverBackend::Dlx ? dlxSolve(board_, stats_) : searchSolve(board_, stats_);
+}
+
+int exactCountSolutions(int board_[9][9], int limit_, SolverBackend backend_, SearchStats* stats_)
+{
+    return backend_ == SolverBackend::Dlx ? dlxCountSolutions(board_, limit_, stats_) : countSolutions(board_, limit_, stats_);
+}
+
+bool checkSolution(const Board& solvedBoard_, const Board& unsolvedBoard_)
+{
+    // Checks to see that the solution is correct: every digit matches the solvedBoard digit.
+    // The boards are compared eight spaces at a time, which compilers turn into a few vector compares.
+    uint64_t difference = solvedBoard_.cells[80] ^ unsolvedBoard_.cells[80];
+    for (int i = 0; i < 80; i += 8)
+    {
+        uint64_t solved, unsolved;
+        std::memcpy(&solved, solvedBoard_.cells + i, sizeof(solved));
+        std::memcpy(&unsolved, unsolvedBoard_.cells + i, sizeof(unsolved));
+        difference |= solved ^ unsolved;
+    }
+    return difference == 0;
+}
+
+bool checkSolution(int solvedBoard_[9][9], int unsolvedBoard_[9][9])
+{
+    for (int i = 0; i < 81; i++)
+    {
+        if (solvedBoard_[i / 9][i % 9] != unsolvedBoard_[i / 9][i % 9]) return false;
+    }
+    return true;
+}
+
+bool sanityCheck(const Board& board_)
+{
+    /*
+    * Check for duplicates of each number in each row, column, and square. Does not consider 0 to be a duplicate.
+    *
+    * Each digit n becomes the single bit (n - 1), and an empty space no bit at all. The bits of a unit add up to the
+    * same as their OR exactly when no two of them are the same, so there's no need to look at each digit on its own.
+    * Row, column and square i are summed up side by side, and the board is only judged once at the end.
+    * A space holding anything past 9 makes the board invalid, the same as in sanityCheckBatch.
+    */
+    uint16_t bits[81];
+    unsigned int repeats = 0;
+    for (int i = 0; i < 81; i++)
+    {
+        repeats |= board_.cells[i] > 9;
+        bits[i] = static_cast<uint16_t>((1u << (board_.cells[i] & 15)) >> 1);
+    }
+
+    const Grid::UnitTables<3>& units = BoardIndex::units;
+
+    for (int i = 0; i < 9; i++)
+    {
+        unsigned int rowSum = 0, rowAny = 0, colSum = 0, colAny = 0, squSum = 0, squAny = 0;
+
+        for (int j = 0; j < 9; j++)
+        {
+            unsigned int row = bits[9 * i + j], col = bits[9 * j + i], squ = bits[units.unitCells[18 + i][j]];
+            rowSum += row;
+            rowAny |= row;
+            colSum += col;
+            colAny |= col;
+            squSum += squ;
+            squAny |= squ;
+        }
+
+        repeats |= (rowSum ^ rowAny) | (colSum ^ colAny) | (squSum ^ squAny);
+    }
+
+    return repeats == 0;
+}
+
+bool sanityCheck(int board_[9][9])
+{
+    Board board;
+    board.load(board_);
+    return sanityCheck(board);
+}
+
+void printBoard(const Board& board_, std::ostream& out_)
+{
+    int board[9][9];
+    board_.store(board);
+    printGrid<3>(board, out_);
+}
+
+void printBoard(int board_[9][9], std::ostream& out_)
+{
+    printGrid<3>(board_, out_);
+}
+
+template <int Box>
+void printGrid(int board_[Box * Box][Box * Box], std::ostream& out_)
+{
+    const int size = Box * Box;
+
+    out_ << std::endl;
+    for (int row = 0; row < size; row++)
+    {
+        if (row != 0 && row % Box == 0)
+        {
+            out_ << " " << std::string(2 * Box, '-');
+            for (int group = 1; group < Box - 1; group++) out_ << "+" << std::string(2 * Box + 1, '-');
+            out_ << "+" << std::string(2 * Box, '-') << std::endl;
+        }
+        for (int col = 0; col < size; col++)
+        {
+            if (col != 0 && col % Box == 0)
+            {
+                out_ << " |";
+            }
+            if (board_[row][col] == 0)
+            {
+                out_ << " -";
+            }
+            else
+            {
+                out_ << " " << Grid::digitChars[board_[row][col]];
+            }
+        }
+
+        out_ << std::endl;
+    }
+}
+
+template void printGrid<3>(int board_[9][9], std::ostream& out_);
+template void printGrid<4>(int board_[16][16], std::ostream& out_);
+template void printGrid<5>(int board_[25][25], std::ostream& out_);
+
+void printBoard(const CandidateBoard& board_, std::ostream& out_)
+{
+    out_ << std::endl;
+    for (int row = 0; row < 9; row++)
+    {
+        if (row == 3 || row == 6)
+        {
+            out_ << " ------------------------------+------------------------------+------------------------------" << std::endl;
+        }
+        for (int col = 0; col < 9; col++)
+        {
+            if (col == 3 || col == 6)
+            {
+                out_ << " |";
+            }
+            Cand::Mask possible = board_.cells[9 * row + col];
+            if (possible == 0)
+            {
+                out_ << " -  ";
+            }
+            else
+            {
+                out_ << " ";
+                int nPrinted = 0;
+                for (int n = 1; n < 10; n++)
+                {
+                    if (possible & Cand::digitMask(n))
+                    {
+                        out_ << n;
+                        nPrinted++;
+                    }
+                }
+                for (; nPrinted < 9; nPrinted++) out_ << " ";
+            }
+        }
+
+        out_ << std::endl;
+    }
+}
+
+bool runAgainCheck()
+{
+    std::string userInput;
+    std::cout << "\nEnter \"quit\" to end program, or anything else to run again." << std::endl;
+    std::cin >> userInput;
+
+    return userInput == "quit" ? false : true;
 }
\ No newline at end of file
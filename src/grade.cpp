@@ -0,0 +1,97 @@
+/**
+* Author: Ryley Robinson
+*
+* grade.cpp: Runs the human methods as a pipeline, and grades puzzles by the work it took. Declared in functions.h.
+*
+* Every round places the spaces that have a single possible digit, then tries each technique in order until one makes
+* progress, and starts the next round from the top. Easier techniques are always preferred, so the score reflects the
+* easiest way a person could solve the puzzle with these methods.
+*/
+
+#include "functions.h"
+#include "stats.h"
+#include "trace.h"
+
+const Technique humanTechniques[] = {
+    { "ruled out digits", 1, removeRuledOut },
+    { "hidden singles", 2, findHiddenSingles },
+    { "pointing pairs", 4, findPointingPairs },
+    { "box-line reduction", 4, findBoxLineReductions },
+    { "naked pairs", 5, findNakedPairs },
+    { "hidden pairs", 6, findHiddenPairs },
+    { "x-wing", 10, findXWings },
+    { "swordfish", 15, findSwordfish }
+};
+
+const int nHumanTechniques = sizeof(humanTechniques) / sizeof(humanTechniques[0]);
+
+static_assert(sizeof(humanTechniques) / sizeof(humanTechniques[0]) == Stats::maxTechniques, "Every human method needs a phase in stats.h");
+
+bool applyTechniques(int board_[9][9], GradeReport* report_, int maxScore_, const Technique* techniques_, int nTechniques_)
+{
+    GradeReport report;
+
+    // The working board represents the board like usual, except each space holds a mask of every possible digit. Helpful for solving algorithm.
+    CandidateBoard workingBoard;
+
+    // Assign the known digits, and fill in the possible digits to spaces without known digits
+    workingBoard.load(board_);
+
+    int nEmpty = 0;
+    for (int i = 0; i < 81; i++)
+    {
+        if (board_[i / 9][i % 9] == 0) nEmpty++;
+    }
+
+    // The main loop. Repeats until no further progress is made
+    bool progress = true;
+    while (progress && report.score <= maxScore_)
+    {
+        progress = false;
+        Stats::count(Stats::Counter::TechniqueRounds);
+
+        // Any space with only one possible digit in workingBoard can be added to the board.
+        {
+            Stats::Timer timer(Stats::Phase::Singles);
+            nEmpty -= placeSingles(workingBoard, board_);
+        }
+        if (nEmpty == 0) break;
+
+        TRACE_BOARD(workingBoard);
+
+        for (int t = 0; t < nTechniques_ && !progress; t++)
+        {
+            // Only the methods of the standard pipeline have phases of their own
+            Stats::Timer timer(Stats::technique(t), techniques_ == humanTechniques);
+
+            if (techniques_[t].apply(workingBoard) > 0)
+            {
+                progress = true;
+                report.score += techniques_[t].weight;
+                if (t < GradeReport::maxTechniques) report.nUses[t]++;
+                if (t > report.hardest) report.hardest = t;
+            }
+        }
+    }
+
+    report.solved = nEmpty == 0;
+
+    // Whatever the techniques couldn't do would have to be guessed
+    if (!report.solved && report.score <= maxScore_) report.score += searchWeight;
+    report.aborted = report.score > maxScore_;
+
+    if (report_) *report_ = report;
+    return report.solved;
+}
+
+int gradeBoard(int board_[9][9], GradeReport* report_, int maxScore_)
+{
+    int board[9][9];
+    for (int i = 0; i < 81; i++) board[i / 9][i % 9] = board_[i / 9][i % 9];
+
+    GradeReport report;
+    applyTechniques(board, &report, maxScore_);
+
+    if (report_) *report_ = report;
+    return report.score;
+}
@@ -0,0 +1,429 @@
+/**
+* Author: Ryley Robinson
+*
+* lanes.cpp: Solves batches of boards in lockstep, one board per SIMD lane. Declared in functions.h.
+*
+* Each of the 81 spaces is one vector holding that space's 16-bit possibility mask for every board in the batch.
+* Every pass over the board, for all lanes at once:
+* - Collect, per row/column/square, the digits of solved spaces and the digits possible in only one space.
+* - Remove solved digits from the other spaces of their units, and reduce a space to its hidden single if it has one.
+* - Flag a lane as broken if a space runs out of digits, a digit is solved twice in a unit, or a digit has nowhere to go.
+* Passes repeat until no lane changes. Lanes that aren't completely solved by then are finished by searchSolve.
+*
+* The kernel is written once over GCC/Clang vector extensions and compiled three times: for AVX2 (16 lanes),
+* for SSE2 (8 lanes, always available on x86-64) and for a single lane in plain scalar code. The widest one
+* the CPU supports is picked at runtime.
+*
+* sanityCheckBatch validates boards the same way, one board per lane. Each digit is its one-bit mask and an empty
+* space is 0, so a unit has no repeats exactly when its masks add up to the same as their OR: two vector operations
+* per space of each unit, for every board in the batch at once.
+*/
+
+#include <cstdint>
+#include <cstring>
+#include "functions.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SUDOKU_LANES_X86 1
+#endif
+
+namespace
+{
+    // The widest batch any kernel handles at once
+    const int maxLanes = 16;
+
+#if defined(__GNUC__)
+    // Every helper below is always inlined into its ISA-specific caller, so the vector calling convention is never used.
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+    typedef uint16_t Lanes16 __attribute__((vector_size(32)));
+    typedef uint16_t Lanes8 __attribute__((vector_size(16)));
+
+    // All bits set in lanes where v_ is zero
+    template <typename V>
+    inline __attribute__((always_inline)) V zeroLanes(V v_)
+    {
+        return (V)(v_ == V{});
+    }
+
+    template <>
+    inline __attribute__((always_inline)) uint16_t zeroLanes<uint16_t>(uint16_t v_)
+    {
+        return v_ == 0 ? 0xFFFF : 0;
+    }
+
+    template <typename V>
+    inline __attribute__((always_inline)) V splat(uint16_t value_)
+    {
+        return V{} + value_;
+    }
+
+    template <>
+    inline __attribute__((always_inline)) uint16_t splat<uint16_t>(uint16_t value_)
+    {
+        return value_;
+    }
+
+    template <typename V>
+    inline __attribute__((always_inline)) bool anyLane(V v_)
+    {
+        for (unsigned k = 0; k < sizeof(V) / sizeof(uint16_t); k++)
+        {
+            if (v_[k] != 0) return true;
+        }
+        return false;
+    }
+
+    template <>
+    inline __attribute__((always_inline)) bool anyLane<uint16_t>(uint16_t v_)
+    {
+        return v_ != 0;
+    }
+
+    /*
+    * Runs elimination passes over cells_ until nothing changes. broken_ gets all bits set in lanes
+    * that reached a contradiction.
+    */
+    template <typename V>
+    inline __attribute__((always_inline)) void eliminateLanes(V* cells_, V& broken_)
+    {
+        const V all = splat<V>(Cand::allDigits);
+        V solvedIn[27], hiddenIn[27];
+
+        for (int pass = 0; pass < 81; pass++)
+        {
+            // Collect what is solved and what is hidden in each unit
+            for (int unit = 0; unit < 27; unit++)
+            {
+                V solvedOnce = V{}, solvedTwice = V{}, once = V{}, twice = V{};
+
+                for (int j = 0; j < 9; j++)
+                {
+                    V mask = cells_[Cand::units.unitCells[unit][j]];
+                    V single = mask & zeroLanes<V>(mask & (mask - 1));
+
+                    solvedTwice |= solvedOnce & single;
+                    solvedOnce |= single;
+                    twice |= once & mask;
+                    once |= mask;
+                }
+
+                broken_ |= ~zeroLanes<V>(solvedTwice) | ~zeroLanes<V>(once ^ all);
+                solvedIn[unit] = solvedOnce;
+                hiddenIn[unit] = once & ~twice;
+            }
+
+            // Remove solved digits from their peers, and reduce spaces to their hidden singles
+            V changed = V{};
+
+            for (int i = 0; i < 81; i++)
+            {
+                const uint8_t* units = Cand::units.cellUnits[i];
+                V mask = cells_[i];
+                V isSingle = zeroLanes<V>(mask & (mask - 1));
+
+                V remaining = mask & ~(solvedIn[units[0]] | solvedIn[units[1]] | solvedIn[units[2]]);
+                V hidden = remaining & (hiddenIn[units[0]] | hiddenIn[units[1]] | hiddenIn[units[2]]);
+                remaining = (hidden & ~zeroLanes<V>(hidden)) | (remaining & zeroLanes<V>(hidden));
+
+                V next = (mask & isSingle) | (remaining & ~isSingle);
+
+                broken_ |= zeroLanes<V>(next);
+                changed |= next ^ mask;
+                cells_[i] = next;
+            }
+
+            if (!anyLane<V>(changed & ~broken_)) return;
+        }
+    }
+
+    // Sets all bits of repeats_ in lanes where a digit is repeated in some row, column or square
+    template <typename V>
+    inline __attribute__((always_inline)) void findRepeatsLanes(const V* cells_, V& repeats_)
+    {
+        for (int unit = 0; unit < 27; unit++)
+        {
+            V sum = V{}, any = V{};
+
+            for (int j = 0; j < 9; j++)
+            {
+                V mask = cells_[Cand::units.unitCells[unit][j]];
+                sum += mask;
+                any |= mask;
+            }
+
+            repeats_ |= ~zeroLanes<V>(sum ^ any);
+        }
+    }
+
+    void eliminateScalar(uint16_t cells_[81][maxLanes], uint16_t broken_[maxLanes], int nLanes_)
+    {
+        for (int lane = 0; lane < nLanes_; lane++)
+        {
+            uint16_t cells[81];
+            for (int i = 0; i < 81; i++) cells[i] = cells_[i][lane];
+
+            eliminateLanes<uint16_t>(cells, broken_[lane]);
+
+            for (int i = 0; i < 81; i++) cells_[i][lane] = cells[i];
+        }
+    }
+
+    template <typename V>
+    inline __attribute__((always_inline)) void eliminateVectors(uint16_t cells_[81][maxLanes], uint16_t broken_[maxLanes], int nLanes_)
+    {
+        const int width = sizeof(V) / sizeof(uint16_t);
+
+        for (int first = 0; first < nLanes_; first += width)
+        {
+            V cells[81], broken;
+            for (int i = 0; i < 81; i++) std::memcpy(&cells[i], &cells_[i][first], sizeof(V));
+            std::memcpy(&broken, &broken_[first], sizeof(V));
+
+            eliminateLanes<V>(cells, broken);
+
+            for (int i = 0; i < 81; i++) std::memcpy(&cells_[i][first], &cells[i], sizeof(V));
+            std::memcpy(&broken_[first], &broken, sizeof(V));
+        }
+    }
+
+    void findRepeatsScalar(uint16_t cells_[81][maxLanes], uint16_t repeats_[maxLanes], int nLanes_)
+    {
+        for (int lane = 0; lane < nLanes_; lane++)
+        {
+            uint16_t cells[81];
+            for (int i = 0; i < 81; i++) cells[i] = cells_[i][lane];
+
+            findRepeatsLanes<uint16_t>(cells, repeats_[lane]);
+        }
+    }
+
+    template <typename V>
+    inline __attribute__((always_inline)) void findRepeatsVectors(uint16_t cells_[81][maxLanes], uint16_t repeats_[maxLanes], int nLanes_)
+    {
+        const int width = sizeof(V) / sizeof(uint16_t);
+
+        for (int first = 0; first < nLanes_; first += width)
+        {
+            V cells[81], repeats;
+            for (int i = 0; i < 81; i++) std::memcpy(&cells[i], &cells_[i][first], sizeof(V));
+            std::memcpy(&repeats, &repeats_[first], sizeof(V));
+
+            findRepeatsLanes<V>(cells, repeats);
+
+            std::memcpy(&repeats_[first], &repeats, sizeof(V));
+        }
+    }
+
+#if defined(SUDOKU_LANES_X86)
+    __attribute__((target("avx2"))) void eliminateAvx2(uint16_t cells_[81][maxLanes], uint16_t broken_[maxLanes], int nLanes_)
+    {
+        eliminateVectors<Lanes16>(cells_, broken_, nLanes_);
+    }
+
+    __attribute__((target("sse2"))) void eliminateSse2(uint16_t cells_[81][maxLanes], uint16_t broken_[maxLanes], int nLanes_)
+    {
+        eliminateVectors<Lanes8>(cells_, broken_, nLanes_);
+    }
+
+    __attribute__((target("avx2"))) void findRepeatsAvx2(uint16_t cells_[81][maxLanes], uint16_t repeats_[maxLanes], int nLanes_)
+    {
+        findRepeatsVectors<Lanes16>(cells_, repeats_, nLanes_);
+    }
+
+    __attribute__((target("sse2"))) void findRepeatsSse2(uint16_t cells_[81][maxLanes], uint16_t repeats_[maxLanes], int nLanes_)
+    {
+        findRepeatsVectors<Lanes8>(cells_, repeats_, nLanes_);
+    }
+#endif
+
+#else
+    void eliminateScalar(uint16_t cells_[81][maxLanes], uint16_t broken_[maxLanes], int nLanes_)
+    {
+        // Without vector extensions every lane is left to the scalar search.
+        (void)cells_;
+        (void)nLanes_;
+        for (int lane = 0; lane < maxLanes; lane++) broken_[lane] = 0;
+    }
+
+    void findRepeatsScalar(uint16_t cells_[81][maxLanes], uint16_t repeats_[maxLanes], int nLanes_)
+    {
+        for (int lane = 0; lane < nLanes_; lane++)
+        {
+            uint16_t sum[27] = {}, any[27] = {};
+            for (int i = 0; i < 81; i++)
+            {
+                for (int k = 0; k < 3; k++)
+                {
+                    sum[Cand::units.cellUnits[i][k]] += cells_[i][lane];
+                    any[Cand::units.cellUnits[i][k]] |= cells_[i][lane];
+                }
+            }
+            for (int unit = 0; unit < 27; unit++)
+            {
+                if (sum[unit] != any[unit]) repeats_[lane] = 0xFFFF;
+            }
+        }
+    }
+#endif
+
+    enum class LaneIsa
+    {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    LaneIsa detectIsa()
+    {
+#if defined(SUDOKU_LANES_X86)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return LaneIsa::Avx2;
+        if (__builtin_cpu_supports("sse2")) return LaneIsa::Sse2;
+#endif
+        return LaneIsa::Scalar;
+    }
+
+    LaneIsa laneIsa()
+    {
+        static const LaneIsa isa = detectIsa();
+        return isa;
+    }
+
+    void eliminate(uint16_t cells_[81][maxLanes], uint16_t broken_[maxLanes], int nLanes_)
+    {
+        switch (laneIsa())
+        {
+#if defined(SUDOKU_LANES_X86)
+        case LaneIsa::Avx2:
+            eliminateAvx2(cells_, broken_, nLanes_);
+            return;
+        case LaneIsa::Sse2:
+            eliminateSse2(cells_, broken_, nLanes_);
+            return;
+#endif
+        default:
+            eliminateScalar(cells_, broken_, nLanes_);
+            return;
+        }
+    }
+
+    void findRepeats(uint16_t cells_[81][maxLanes], uint16_t repeats_[maxLanes], int nLanes_)
+    {
+        switch (laneIsa())
+        {
+#if defined(SUDOKU_LANES_X86)
+        case LaneIsa::Avx2:
+            findRepeatsAvx2(cells_, repeats_, nLanes_);
+            return;
+        case LaneIsa::Sse2:
+            findRepeatsSse2(cells_, repeats_, nLanes_);
+            return;
+#endif
+        default:
+            findRepeatsScalar(cells_, repeats_, nLanes_);
+            return;
+        }
+    }
+}
+
+const char* batchSolveIsa()
+{
+    switch (laneIsa())
+    {
+    case LaneIsa::Avx2: return "avx2";
+    case LaneIsa::Sse2: return "sse2";
+    default: return "scalar";
+    }
+}
+
+int batchSolve(int (*boards_)[9][9], int nBoards_, bool* solved_)
+{
+    int nSolved = 0;
+
+    for (int first = 0; first < nBoards_; first += maxLanes)
+    {
+        int nLanes = nBoards_ - first < maxLanes ? nBoards_ - first : maxLanes;
+
+        alignas(32) uint16_t cells[81][maxLanes];
+        alignas(32) uint16_t broken[maxLanes] = {};
+
+        // Unused lanes stay empty and broken, so they drop out of the change test straight away
+        for (int i = 0; i < 81; i++)
+        {
+            for (int lane = 0; lane < maxLanes; lane++)
+            {
+                int n = lane < nLanes ? boards_[first + lane][i / 9][i % 9] : 0;
+                cells[i][lane] = n != 0 ? Cand::digitMask(n) : (lane < nLanes ? Cand::allDigits : 0);
+            }
+        }
+        for (int lane = nLanes; lane < maxLanes; lane++) broken[lane] = 0xFFFF;
+
+        eliminate(cells, broken, nLanes);
+
+        for (int lane = 0; lane < nLanes; lane++)
+        {
+            int (&board)[9][9] = boards_[first + lane];
+            bool solved = false;
+
+            if (broken[lane] == 0)
+            {
+                // Write every solved space back, then let the search finish whatever is left
+                bool complete = true;
+                for (int i = 0; i < 81; i++)
+                {
+                    Cand::Mask mask = cells[i][lane];
+                    if (Cand::countDigits(mask) == 1) board[i / 9][i % 9] = Cand::firstDigit(mask);
+                    else complete = false;
+                }
+
+                solved = complete ? sanityCheck(board) : searchSolve(board);
+            }
+
+            if (solved_) solved_[first + lane] = solved;
+            if (solved) nSolved++;
+        }
+    }
+
+    return nSolved;
+}
+
+int sanityCheckBatch(const Board* boards_, int nBoards_, bool* valid_)
+{
+    int nValid = 0;
+
+    for (int first = 0; first < nBoards_; first += maxLanes)
+    {
+        int nLanes = nBoards_ - first < maxLanes ? nBoards_ - first : maxLanes;
+
+        alignas(32) uint16_t cells[81][maxLanes];
+        alignas(32) uint16_t repeats[maxLanes] = {};
+
+        // Empty spaces and unused lanes hold no digit, so they never count as a repeat. A space holding anything past 9
+        // makes its board invalid straight away, and holds no digit either: its bit could wrap the 16-bit sums.
+        for (int i = 0; i < 81; i++)
+        {
+            for (int lane = 0; lane < maxLanes; lane++)
+            {
+                int n = lane < nLanes ? boards_[first + lane].cells[i] : 0;
+                if (n > 9)
+                {
+                    repeats[lane] = 0xFFFF;
+                    n = 0;
+                }
+                cells[i][lane] = static_cast<uint16_t>((1u << n) >> 1);
+            }
+        }
+
+        findRepeats(cells, repeats, nLanes);
+
+        for (int lane = 0; lane < nLanes; lane++)
+        {
+            bool valid = repeats[lane] == 0;
+            if (valid_) valid_[first + lane] = valid;
+            if (valid) nValid++;
+        }
+    }
+
+    return nValid;
+}
@@ -0,0 +1,276 @@
+/**
+* Author: Ryley Robinson
+*
+* parallel.cpp: Search of a single puzzle spread over many threads. Declared in functions.h.
+*
+* Splitting the search:
+* - The calling thread starts the search on its own. Most puzzles are done within the first few thousand nodes, and
+*   never start a thread.
+* - Otherwise helper threads join in, and wait with nothing to do. Every few hundred nodes, a thread that is searching
+*   checks whether any are waiting, and if so splits the digits still untried at its shallowest guess off as tasks of
+*   their own (see SearchEngine::split). Guesses near the top of the tree lead to the largest parts of the search, so
+*   a few splits keep every thread busy, and a thread stuck in a large part gives it away bit by bit.
+* - A thread that finishes its task takes the next one, or waits for one. The search is over once no thread is
+*   searching and no task is left.
+*
+* Solving stops every thread as soon as one of them finds a solution. Counting adds up the solutions of every task,
+* and stops every thread once the limit is reached.
+*
+* The helper threads are started the first time they are needed and kept for the rest of the program, so a stream of
+* hard puzzles doesn't pay for starting threads on every one. They help one search at a time: a search started while
+* they are busy with another runs on its calling thread alone.
+*/
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "functions.h"
+
+namespace
+{
+    // Nodes the calling thread searches alone before the helpers join in
+    const long long serialNodes = 2048;
+
+    // Nodes between checks for waiting threads
+    const long long sliceNodes = 256;
+
+    struct SharedSearch
+    {
+        std::mutex lock;
+        std::condition_variable wake;
+
+        std::deque<Board> tasks;
+        int nSearching = 0;
+
+        // Threads waiting for a task. Read without the lock by the threads that are searching.
+        std::atomic<int> nWaiting{ 0 };
+
+        // Set once the limit is reached
+        std::atomic<bool> stop{ false };
+
+        std::atomic<long long> nSolutions{ 0 };
+        std::atomic<long long> nodes{ 0 };
+        long long limit = 0;
+
+        // The first solution found, if it is wanted. Only read once every thread has been joined.
+        bool keepSolution = false;
+        Board solution;
+    };
+
+    void foundSolution(SearchEngine& engine_, SharedSearch& shared_)
+    {
+        long long n = shared_.nSolutions.fetch_add(1) + 1;
+        if (n == 1 && shared_.keepSolution) engine_.store(shared_.solution);
+
+        if (n >= shared_.limit)
+        {
+            shared_.stop.store(true);
+
+            std::lock_guard<std::mutex> guard(shared_.lock);
+            shared_.wake.notify_all();
+        }
+    }
+
+    // Splits off one task for each waiting thread, as far as the engine has untried digits left
+    void share(SearchEngine& engine_, SharedSearch& shared_)
+    {
+        std::lock_guard<std::mutex> guard(shared_.lock);
+
+        Board task;
+        while (static_cast<int>(shared_.tasks.size()) < shared_.nWaiting.load() && engine_.split(task)) shared_.tasks.push_back(task);
+        shared_.wake.notify_all();
+    }
+
+    // Searches the task loaded into engine_ to the end, or until the limit is reached
+    void searchTask(SearchEngine& engine_, SharedSearch& shared_)
+    {
+        SearchLimits limits;
+        limits.maxNodes = sliceNodes;
+        limits.cancel = &shared_.stop;
+
+        while (true)
+        {
+            SearchStatus status = engine_.run(limits);
+
+            if (status == SearchStatus::Solved) foundSolution(engine_, shared_);
+            else if (status == SearchStatus::OutOfBudget && shared_.nWaiting.load(std::memory_order_relaxed) > 0) share(engine_, shared_);
+            else if (status != SearchStatus::OutOfBudget) break;
+        }
+
+        shared_.nodes += engine_.nodesVisited();
+    }
+
+    // Searches tasks until there are none left. searching_ is true if engine_ already holds one.
+    void worker(SharedSearch& shared_, SearchEngine& engine_, bool searching_)
+    {
+        std::unique_lock<std::mutex> guard(shared_.lock, std::defer_lock);
+
+        while (true)
+        {
+            if (searching_)
+            {
+                searchTask(engine_, shared_);
+
+                guard.lock();
+                if (--shared_.nSearching == 0 && shared_.tasks.empty()) shared_.wake.notify_all();
+            }
+            else guard.lock();
+
+            shared_.nWaiting++;
+            shared_.wake.wait(guard, [&]() { return !shared_.tasks.empty() || shared_.nSearching == 0 || shared_.stop.load(); });
+            shared_.nWaiting--;
+
+            if (shared_.tasks.empty() || shared_.stop.load()) return;
+
+            engine_.load(shared_.tasks.front());
+            shared_.tasks.pop_front();
+            shared_.nSearching++;
+            guard.unlock();
+
+            searching_ = true;
+        }
+    }
+
+    // Helper threads shared by every search
+    class HelperPool
+    {
+    public:
+        // Lets nHelpers_ helpers join the search, starting more if there aren't enough yet. Returns false if another
+        // search has the helpers.
+        bool begin(SharedSearch& shared_, int nHelpers_)
+        {
+            std::unique_lock<std::mutex> owner(busy, std::try_to_lock);
+            if (!owner.owns_lock()) return false;
+
+            std::lock_guard<std::mutex> guard(lock);
+            while (static_cast<int>(helpers.size()) < nHelpers_) helpers.emplace_back(&HelperPool::help, this);
+
+            search = &shared_;
+            nWanted = nHelpers_;
+            nJoined = 0;
+            wake.notify_all();
+
+            owner.release();
+            return true;
+        }
+
+        // Waits for every helper that joined the search to leave it
+        void end()
+        {
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                search = nullptr;
+                left.wait(guard, [&]() { return nActive == 0; });
+            }
+            busy.unlock();
+        }
+
+    private:
+        // Held from begin() to end()
+        std::mutex busy;
+
+        std::mutex lock;
+        std::condition_variable wake, left;
+        std::vector<std::thread> helpers;
+
+        SharedSearch* search = nullptr;
+        int nWanted = 0;
+        int nJoined = 0;
+        int nActive = 0;
+
+        void help()
+        {
+            SearchEngine engine;
+            std::unique_lock<std::mutex> guard(lock);
+
+            while (true)
+            {
+                wake.wait(guard, [&]() { return search != nullptr && nJoined < nWanted; });
+
+                SharedSearch* shared = search;
+                nJoined++;
+                nActive++;
+                guard.unlock();
+
+                worker(*shared, engine, false);
+
+                guard.lock();
+                if (--nActive == 0) left.notify_all();
+            }
+        }
+    };
+
+    // Never destroyed, since its threads never finish
+    HelperPool& helperPool()
+    {
+        static HelperPool* pool = new HelperPool;
+        return *pool;
+    }
+
+    // Counts solutions up to limit_ on nThreads_ threads, and writes the first one found to solution_
+    long long parallelSearch(int board_[9][9], long long limit_, int nThreads_, int (*solution_)[9], SearchStats* stats_)
+    {
+        if (nThreads_ <= 0) nThreads_ = static_cast<int>(std::thread::hardware_concurrency());
+        if (nThreads_ <= 0) nThreads_ = 1;
+
+        SharedSearch shared;
+        shared.limit = limit_ > 0 ? limit_ : LLONG_MAX;
+        shared.keepSolution = solution_ != nullptr;
+
+        SearchEngine engine;
+        engine.load(board_);
+
+        // The serial budget covers the whole search, however many solutions it finds along the way
+        SearchStatus status = SearchStatus::OutOfBudget;
+        while (!shared.stop.load())
+        {
+            SearchLimits limits;
+            if (nThreads_ > 1)
+            {
+                limits.maxNodes = serialNodes - engine.nodesVisited();
+                if (limits.maxNodes <= 0)
+                {
+                    status = SearchStatus::OutOfBudget;
+                    break;
+                }
+            }
+
+            status = engine.run(limits);
+            if (status != SearchStatus::Solved) break;
+            foundSolution(engine, shared);
+        }
+
+        if (status == SearchStatus::OutOfBudget && !shared.stop.load())
+        {
+            shared.nSearching = 1;
+
+            HelperPool& pool = helperPool();
+            bool helped = pool.begin(shared, nThreads_ - 1);
+
+            // The calling thread carries on with the search it started. Without helpers, nothing is ever split off.
+            worker(shared, engine, true);
+
+            if (helped) pool.end();
+        }
+        else shared.nodes += engine.nodesVisited();
+
+        if (stats_) stats_->nodesVisited += shared.nodes.load();
+
+        long long nSolutions = std::min(shared.nSolutions.load(), shared.limit);
+        if (nSolutions > 0 && shared.keepSolution) shared.solution.store(solution_);
+        return nSolutions;
+    }
+}
+
+bool parallelSolve(int board_[9][9], int nThreads_, SearchStats* stats_)
+{
+    return parallelSearch(board_, 1, nThreads_, board_, stats_) > 0;
+}
+
+long long parallelCountSolutions(int board_[9][9], long long limit_, int nThreads_, SearchStats* stats_)
+{
+    return parallelSearch(board_, limit_, nThreads_, nullptr, stats_);
+}
@@ -0,0 +1,236 @@
+/**
+* Author: Ryley Robinson
+*
+* search.cpp: Constraint-propagating backtracking search. Declared in functions.h and search.h.
+*
+* Algorithm:
+* - Place every naked single (a space with one possible digit) and hidden single (a digit with one possible space in a unit).
+* - Repeat until nothing changes. Stop if a space or a digit has nowhere to go.
+* - Pick the empty space with the fewest possible digits and try each of them in turn, repeating from the start.
+*
+* Everything is written for any box size, and instantiated for 9 x 9, 16 x 16 and 25 x 25 boards at the bottom.
+*/
+
+#include "functions.h"
+#include "search.h"
+
+template <int Box>
+bool BasicSearchState<Box>::load(int board_[T::size][T::size])
+{
+    for (int i = 0; i < T::size; i++) rowUsed[i] = colUsed[i] = squUsed[i] = 0;
+    nEmpty = T::cells;
+
+    for (int i = 0; i < T::cells; i++)
+    {
+        digits[i] = 0;
+
+        int n = board_[i / T::size][i % T::size];
+        if (n == 0) continue;
+
+        // A given digit that is already used in its row, column or square can never be part of a solution
+        if (n < 0 || n > T::size || (possible(i) & Grid::digitMask<Mask>(n)) == 0) return false;
+
+        place(i, n);
+    }
+
+    return true;
+}
+
+template <int Box>
+void BasicSearchState<Box>::store(int board_[T::size][T::size]) const
+{
+    for (int i = 0; i < T::cells; i++) board_[i / T::size][i % T::size] = digits[i];
+}
+
+template <int Box>
+void BasicSearchState<Box>::place(int index_, int n_)
+{
+    int row = index_ / T::size, col = index_ % T::size;
+    Mask bit = Grid::digitMask<Mask>(n_);
+
+    digits[index_] = static_cast<uint8_t>(n_);
+    rowUsed[row] |= bit;
+    colUsed[col] |= bit;
+    squUsed[Grid::squareOf<Box>(row, col)] |= bit;
+    nEmpty--;
+}
+
+template <int Box>
+void BasicSearchState<Box>::remove(int index_)
+{
+    int row = index_ / T::size, col = index_ % T::size;
+    Mask bit = Grid::digitMask<Mask>(digits[index_]);
+
+    digits[index_] = 0;
+    rowUsed[row] &= ~bit;
+    colUsed[col] &= ~bit;
+    squUsed[Grid::squareOf<Box>(row, col)] &= ~bit;
+    nEmpty++;
+}
+
+template <int Box>
+bool BasicSearchState<Box>::propagate()
+{
+    return propagate([](int) {});
+}
+
+template <int Box>
+int BasicSearchState<Box>::pickSpace() const
+{
+    int best = -1, bestCount = T::size + 1;
+
+    for (int i = 0; i < T::cells && bestCount > 2; i++)
+    {
+        if (digits[i] != 0) continue;
+
+        int count = Grid::countDigits(possible(i));
+        if (count < bestCount)
+        {
+            best = i;
+            bestCount = count;
+        }
+    }
+
+    return best;
+}
+
+namespace
+{
+    // Counts the solutions reachable from state_, stopping as soon as limit_ are found. The first one is copied into solution_.
+    template <int Box>
+    int count(BasicSearchState<Box>& state_, int limit_, BasicSearchState<Box>* solution_, SearchStats* stats_)
+    {
+        if (stats_) stats_->nodesVisited++;
+
+        if (!state_.propagate()) return 0;
+
+        if (state_.nEmpty == 0)
+        {
+            if (solution_) *solution_ = state_;
+            return 1;
+        }
+
+        int index = state_.pickSpace();
+        typename BasicSearchState<Box>::Mask mask = state_.possible(index);
+        int found = 0;
+
+        while (mask != 0 && found < limit_)
+        {
+            int n = Grid::firstDigit(mask);
+            mask &= mask - 1;
+
+            BasicSearchState<Box> next = state_;
+            next.place(index, n);
+
+            found += count(next, limit_ - found, found == 0 ? solution_ : nullptr, stats_);
+        }
+
+        return found;
+    }
+}
+
+template <int Box>
+bool solveGrid(int board_[Box * Box][Box * Box], SearchStats* stats_)
+{
+    BasicSearchState<Box> state, solution;
+    if (!state.load(board_)) return false;
+
+    if (count(state, 1, &solution, stats_) == 0) return false;
+
+    solution.store(board_);
+    return true;
+}
+
+template <int Box>
+int countGridSolutions(int board_[Box * Box][Box * Box], int limit_, SearchStats* stats_)
+{
+    BasicSearchState<Box> state;
+    if (!state.load(board_)) return 0;
+
+    return count(state, limit_, static_cast<BasicSearchState<Box>*>(nullptr), stats_);
+}
+
+template <int Box>
+bool BasicRemovalState<Box>::load(int solvedBoard_[T::size][T::size])
+{
+    givenSpaces.set();
+    nWitnesses = 0;
+
+    if (!givens.load(solvedBoard_) || givens.nEmpty != 0) return false;
+
+    solved = givens;
+    return true;
+}
+
+template <int Box>
+bool BasicRemovalState<Box>::tryRemove(int index_, SearchStats* stats_)
+{
+    int n = givens.digits[index_];
+    if (n == 0) return false;
+
+    // A remembered second solution that only this given still rules out
+    for (int w = 0; w < nWitnesses && w < maxWitnesses; w++)
+    {
+        if (witnesses[w].test(index_) && (witnesses[w] & givenSpaces).count() == 1) return false;
+    }
+
+    givens.remove(index_);
+
+    // Try every other digit the space could hold. Any solution found with one of them means two solutions.
+    typename BasicSearchState<Box>::Mask others = givens.possible(index_) & ~Grid::digitMask<typename T::Mask>(n);
+    while (others != 0)
+    {
+        BasicSearchState<Box> next = givens, solution;
+        next.place(index_, Grid::firstDigit(others));
+        others &= others - 1;
+
+        if (count(next, 1, &solution, stats_) > 0)
+        {
+            std::bitset<T::cells>& witness = witnesses[nWitnesses++ % maxWitnesses];
+            witness.reset();
+            for (int i = 0; i < T::cells; i++)
+            {
+                if (solution.digits[i] != solved.digits[i]) witness.set(i);
+            }
+
+            givens.place(index_, n);
+            return false;
+        }
+    }
+
+    givenSpaces.reset(index_);
+    return true;
+}
+
+template <int Box>
+void BasicRemovalState<Box>::restore(int index_, int n_)
+{
+    givens.place(index_, n_);
+    givenSpaces.set(index_);
+}
+
+bool searchSolve(int board_[9][9], SearchStats* stats_)
+{
+    return solveGrid<3>(board_, stats_);
+}
+
+int countSolutions(int board_[9][9], int limit_, SearchStats* stats_)
+{
+    return countGridSolutions<3>(board_, limit_, stats_);
+}
+
+template struct BasicSearchState<3>;
+template struct BasicSearchState<4>;
+template struct BasicSearchState<5>;
+
+template struct BasicRemovalState<3>;
+template struct BasicRemovalState<4>;
+template struct BasicRemovalState<5>;
+
+template bool solveGrid<3>(int board_[9][9], SearchStats* stats_);
+template bool solveGrid<4>(int board_[16][16], SearchStats* stats_);
+template bool solveGrid<5>(int board_[25][25], SearchStats* stats_);
+
+template int countGridSolutions<3>(int board_[9][9], int limit_, SearchStats* stats_);
+template int countGridSolutions<4>(int board_[16][16], int limit_, SearchStats* stats_);
+template int countGridSolutions<5>(int board_[25][25], int limit_, SearchStats* stats_);
@@ -0,0 +1,569 @@
+/**
+* Author: Ryley Robinson
+*
+* service.cpp: Long-running solver service. Declared in service.h.
+*
+* One reader per client (stdin, or each socket connection) splits the input into lines and pushes them onto a single
+* bounded queue. A fixed pool of workers takes requests off the queue, and writes each answer straight back to the
+* client it came from. A reader that finds the queue full waits, so a client can never have more than the queue's
+* worth of requests in flight, and the rest stays in its socket buffer.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "functions.h"
+#include "service.h"
+#include "stats.h"
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // How long a worker waits on a socket client that isn't reading its answers before disconnecting it
+    const int sendTimeoutSeconds = 10;
+
+    // Digits a generate request may ask to remove. Boards with fewer than 21 clues can take seconds to minutes.
+    const int maxDigitsToRemove = 60;
+
+    // Where the answers to one client go. Workers answer at the same time, so every write takes the lock.
+    class Client
+    {
+    public:
+        explicit Client(std::ostream& stream_) : stream(&stream_) {}
+        explicit Client(int socket_) : socket(socket_) {}
+
+        Client(const Client&) = delete;
+        Client& operator=(const Client&) = delete;
+
+        ~Client()
+        {
+#if !defined(_WIN32)
+            if (socket >= 0) ::close(socket);
+#endif
+        }
+
+        void send(const std::string& line_)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+
+            if (stream)
+            {
+                stream->write(line_.data(), static_cast<std::streamsize>(line_.size()));
+                stream->flush();
+                return;
+            }
+
+#if !defined(_WIN32)
+#if defined(MSG_NOSIGNAL)
+            const int flags = MSG_NOSIGNAL;
+#else
+            const int flags = 0;
+#endif
+            // A client that went away, or stopped reading for longer than the send timeout, is disconnected, so
+            // it can't hold up the workers answering everyone else
+            size_t sent = 0;
+            while (!dropped && sent < line_.size())
+            {
+                ssize_t n = ::send(socket, line_.data() + sent, line_.size() - sent, flags);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0)
+                {
+                    shutdown(socket, SHUT_RDWR);
+                    dropped = true;
+                }
+                else sent += static_cast<size_t>(n);
+            }
+#endif
+        }
+
+#if !defined(_WIN32)
+        // Makes the next read of the socket report the end of the connection. Answers can still be sent.
+        void stopReading()
+        {
+            if (socket >= 0) shutdown(socket, SHUT_RD);
+        }
+#endif
+
+    private:
+        std::mutex lock;
+        std::ostream* stream = nullptr;
+        int socket = -1;
+        bool dropped = false;
+    };
+
+    struct Request
+    {
+        std::shared_ptr<Client> client;
+        std::string line;
+    };
+
+    // Requests waiting for a worker, in a ring allocated once
+    class RequestQueue
+    {
+    public:
+        explicit RequestQueue(size_t capacity_) : slots(capacity_ > 0 ? capacity_ : 1) {}
+
+        // Waits while the queue is full. Returns false if the queue was closed.
+        bool push(Request& request_)
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            notFull.wait(guard, [&]() { return count < slots.size() || closed; });
+            if (closed) return false;
+
+            // Swapped rather than moved, so the line buffers go round the ring and are reused instead of reallocated
+            Request& slot = slots[(head + count) % slots.size()];
+            slot.client.swap(request_.client);
+            slot.line.swap(request_.line);
+            count++;
+            notEmpty.notify_one();
+            return true;
+        }
+
+        // Waits while the queue is empty. Returns false once it is closed and nothing is left.
+        bool pop(Request& request_)
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            notEmpty.wait(guard, [&]() { return count > 0 || closed; });
+            if (count == 0) return false;
+
+            slots[head].client.swap(request_.client);
+            slots[head].line.swap(request_.line);
+            head = (head + 1) % slots.size();
+            count--;
+            notFull.notify_one();
+            return true;
+        }
+
+        // Lets the workers finish what is queued, then stop
+        void close()
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            closed = true;
+            notEmpty.notify_all();
+            notFull.notify_all();
+        }
+
+    private:
+        std::mutex lock;
+        std::condition_variable notEmpty, notFull;
+        std::vector<Request> slots;
+        size_t head = 0;
+        size_t count = 0;
+        bool closed = false;
+    };
+
+    // Everything a worker reuses from one request to the next, including the search engine for solve requests, so
+    // nothing here is shared.
+    struct WorkerState
+    {
+        Rng rng;
+        SearchEngine engine;
+        SearchLimits limits;
+        int board[9][9];
+        int solved[9][9];
+        std::string response;
+    };
+
+    bool parsePuzzle(std::string_view text_, int board_[9][9])
+    {
+        if (text_.size() != 81) return false;
+
+        for (int i = 0; i < 81; i++)
+        {
+            int n = Grid::charToDigit(text_[i], 9);
+            if (n < 0) return false;
+            board_[i / 9][i % 9] = n;
+        }
+        return true;
+    }
+
+    void appendBoard(std::string& out_, int board_[9][9])
+    {
+        for (int i = 0; i < 81; i++)
+        {
+            int n = board_[i / 9][i % 9];
+            out_ += n == 0 ? '.' : Grid::digitChars[n];
+        }
+    }
+
+    // Splits the next word off text_ starting at pos_, moving pos_ past it and the spaces after it
+    std::string_view nextWord(std::string_view text_, size_t& pos_)
+    {
+        size_t end = text_.find(' ', pos_);
+        if (end == std::string_view::npos) end = text_.size();
+
+        std::string_view word = text_.substr(pos_, end - pos_);
+        pos_ = text_.find_first_not_of(' ', end);
+        if (pos_ == std::string_view::npos) pos_ = text_.size();
+        return word;
+    }
+
+    // Answers one request line into state_.response. Returns false if the answer is an error.
+    bool handle(const std::string& line_, WorkerState& state_, const ServiceOptions& options_)
+    {
+        std::string& response = state_.response;
+        response.clear();
+
+        // Views into the request line, so reading a request doesn't allocate
+        size_t pos = 0;
+        std::string_view line = line_;
+        std::string_view id = nextWord(line, pos);
+        std::string_view command = nextWord(line, pos);
+        std::string_view argument = line.substr(pos);
+
+        response += id;
+        auto fail = [&](const char* reason_)
+        {
+            response += " error ";
+            response += reason_;
+            response += '\n';
+            return false;
+        };
+
+        if (command == "solve" || command == "grade")
+        {
+            if (!parsePuzzle(argument, state_.board)) return fail("expected an 81 character puzzle");
+            if (!sanityCheck(state_.board)) return fail("puzzle repeats a digit");
+
+            if (command == "grade")
+            {
+                GradeReport grade;
+                gradeBoard(state_.board, &grade);
+                response += " ok ";
+                response += std::to_string(grade.score);
+                response += ' ';
+                response += !grade.solved ? "search" : grade.hardest < 0 ? "singles" : humanTechniques[grade.hardest].name;
+            }
+            else
+            {
+                // The iterative search, so a solve request can't take longer than the limits allow
+                state_.engine.load(state_.board);
+                SearchStatus status = state_.engine.run(state_.limits);
+                if (status == SearchStatus::OutOfBudget) return fail("search limit reached");
+                if (status != SearchStatus::Solved) return fail("no solution");
+
+                state_.engine.store(state_.board);
+                response += " ok ";
+                appendBoard(response, state_.board);
+            }
+        }
+        else if (command == "generate")
+        {
+            int nDigitsToRemove = options_.nDigitsToRemove;
+            if (!argument.empty())
+            {
+                int n = 0;
+                for (char c : argument)
+                {
+                    if (c < '0' || c > '9' || n > maxDigitsToRemove) return fail("expected a number of digits to remove from 0 to 60");
+                    n = 10 * n + (c - '0');
+                }
+                if (n > maxDigitsToRemove) return fail("expected a number of digits to remove from 0 to 60");
+                nDigitsToRemove = n;
+            }
+            if (!options_.seedBoard) return fail("no seed board");
+
+            while (!createBoard(nDigitsToRemove, options_.seedBoard, state_.solved, state_.board, state_.rng))
+            {
+                continue;
+            }
+
+            response += " ok ";
+            appendBoard(response, state_.board);
+            response += ' ';
+            appendBoard(response, state_.solved);
+        }
+        else if (command == "stats")
+        {
+            if (!Stats::enabled()) return fail("statistics are off (start the service with --stats)");
+            if (!argument.empty() && argument != "json" && argument != "prometheus") return fail("expected json or prometheus");
+
+            std::ostringstream out;
+            if (argument == "prometheus") Stats::writePrometheus(Stats::collect(), out);
+            else Stats::writeJson(Stats::collect(), out);
+            std::string text = out.str();
+
+            // The Prometheus format takes many lines, so they follow the response, which says how many there are
+            response += " ok ";
+            if (argument == "prometheus")
+            {
+                response += std::to_string(std::count(text.begin(), text.end(), '\n'));
+                response += '\n';
+                response += text;
+                return true;
+            }
+            response += text;
+        }
+        else
+        {
+            return fail("unknown command");
+        }
+
+        response += '\n';
+        return true;
+    }
+
+    class WorkerPool
+    {
+    public:
+        WorkerPool(RequestQueue& queue_, const ServiceOptions& options_) : queue(queue_), options(options_)
+        {
+            int nWorkers = options_.nWorkers > 0 ? options_.nWorkers : static_cast<int>(std::thread::hardware_concurrency());
+            if (nWorkers <= 0) nWorkers = 1;
+
+            for (int w = 0; w < nWorkers; w++) threads.emplace_back(&WorkerPool::run, this, w);
+        }
+
+        ~WorkerPool()
+        {
+            join();
+        }
+
+        // Waits for the workers to stop. The queue has to be closed first.
+        void join()
+        {
+            for (std::thread& thread : threads)
+            {
+                if (thread.joinable()) thread.join();
+            }
+        }
+
+        long long nRequests() const { return requests.load(); }
+        long long nErrors() const { return errors.load(); }
+
+    private:
+        void run(int index_)
+        {
+            WorkerState state;
+            state.rng = Rng::stream(options.seed, static_cast<uint64_t>(index_));
+            state.response.reserve(256);
+            state.limits.maxNodes = options.solveNodeLimit;
+            state.limits.maxTime = options.solveTimeLimit;
+
+            Request request;
+            while (queue.pop(request))
+            {
+                {
+                    Stats::Timer timer(Stats::Phase::Request);
+                    if (!handle(request.line, state, options))
+                    {
+                        errors++;
+                        Stats::count(Stats::Counter::RequestErrors);
+                    }
+                    requests++;
+                    Stats::count(Stats::Counter::Requests);
+                }
+
+                request.client->send(state.response);
+
+                // Drop the client now, so a finished socket is closed without waiting for the next request
+                request.client.reset();
+            }
+        }
+
+        RequestQueue& queue;
+        const ServiceOptions& options;
+        std::vector<std::thread> threads;
+        std::atomic<long long> requests{ 0 };
+        std::atomic<long long> errors{ 0 };
+    };
+
+    // Queues every non-empty line of text read so far from partial_ plus data_, keeping an unfinished last line in partial_.
+    // request_ is reused for every line, and holds the client to answer.
+    bool queueLines(std::string& partial_, const char* data_, size_t size_, Request& request_, RequestQueue& queue_)
+    {
+        partial_.append(data_, size_);
+
+        size_t start = 0, end;
+        while ((end = partial_.find('\n', start)) != std::string::npos)
+        {
+            size_t length = end - start;
+            if (length > 0 && partial_[end - 1] == '\r') length--;
+
+            if (length > 0)
+            {
+                std::shared_ptr<Client> client = request_.client;
+                request_.line.assign(partial_, start, length);
+                if (!queue_.push(request_)) return false;
+                request_.client = std::move(client);
+            }
+            start = end + 1;
+        }
+
+        partial_.erase(0, start);
+        return true;
+    }
+
+#if !defined(_WIN32)
+    // One client connection, and the thread reading its requests. The socket is closed once the reader and every
+    // answer still to be sent are done with the client, so only a weak reference is kept here.
+    struct Connection
+    {
+        std::weak_ptr<Client> client;
+        std::thread reader;
+        std::atomic<bool> finished{ false };
+    };
+
+    // Reads requests from one socket connection until the client closes it, or the queue is closed
+    void readSocket(int socket_, std::shared_ptr<Client> client_, Connection& connection_, RequestQueue& queue_)
+    {
+        timeval timeout = {};
+        timeout.tv_sec = sendTimeoutSeconds;
+        setsockopt(socket_, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        Request request;
+        request.client = std::move(client_);
+        std::string partial;
+        char buffer[1 << 14];
+        bool open = true;
+
+        while (open)
+        {
+            ssize_t n = recv(socket_, buffer, sizeof(buffer), 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            open = queueLines(partial, buffer, static_cast<size_t>(n), request, queue_);
+        }
+
+        // A last request without a line break
+        if (open && !partial.empty()) queueLines(partial, "\n", 1, request, queue_);
+
+        connection_.finished = true;
+    }
+
+    // Joins the readers of connections that have closed, and forgets them
+    void joinFinished(std::vector<std::unique_ptr<Connection>>& connections_)
+    {
+        for (size_t c = 0; c < connections_.size();)
+        {
+            if (!connections_[c]->finished.load())
+            {
+                c++;
+                continue;
+            }
+
+            connections_[c]->reader.join();
+            connections_[c] = std::move(connections_.back());
+            connections_.pop_back();
+        }
+    }
+#endif
+}
+
+ServiceReport serveStream(std::istream& in_, std::ostream& out_, const ServiceOptions& options_)
+{
+    ServiceReport report;
+    auto start = std::chrono::steady_clock::now();
+
+    RequestQueue queue(options_.queueCapacity);
+    WorkerPool pool(queue, options_);
+    std::shared_ptr<Client> client = std::make_shared<Client>(out_);
+
+    // in_ would flush its tied stream (std::cout for std::cin) before every read, from this thread, while the
+    // workers are writing to it
+    std::ostream* tied = in_.tie(nullptr);
+
+    // Reading into the line of a request the queue handed back reuses its buffer
+    Request request;
+    while (std::getline(in_, request.line))
+    {
+        if (!request.line.empty() && request.line.back() == '\r') request.line.pop_back();
+        if (request.line.empty()) continue;
+
+        request.client = client;
+        if (!queue.push(request)) break;
+    }
+
+    queue.close();
+    pool.join();
+    in_.tie(tied);
+
+    report.nRequests = pool.nRequests();
+    report.nErrors = pool.nErrors();
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+bool serveSocket(const std::string& path_, const ServiceOptions& options_)
+{
+#if defined(_WIN32)
+    (void)path_;
+    (void)options_;
+    return false;
+#else
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path_.empty() || path_.size() >= sizeof(address.sun_path)) return false;
+    std::memcpy(address.sun_path, path_.c_str(), path_.size() + 1);
+
+    // A socket file left behind by an earlier run would make bind fail. Anything else at the path is left alone.
+    struct stat status;
+    if (lstat(path_.c_str(), &status) == 0)
+    {
+        if (!S_ISSOCK(status.st_mode))
+        {
+            std::cerr << "\"" << path_ << "\" already exists and is not a socket." << std::endl;
+            return false;
+        }
+        unlink(path_.c_str());
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) return false;
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0)
+    {
+        ::close(listener);
+        return false;
+    }
+
+    RequestQueue queue(options_.queueCapacity);
+    WorkerPool pool(queue, options_);
+
+    // Every reader pushes to the queue, so all of them are joined before it goes away
+    std::vector<std::unique_ptr<Connection>> connections;
+
+    while (true)
+    {
+        int descriptor = accept(listener, nullptr, nullptr);
+        if (descriptor < 0 && errno == EINTR) continue;
+        if (descriptor < 0) break;
+
+        joinFinished(connections);
+
+        std::shared_ptr<Client> client = std::make_shared<Client>(descriptor);
+        std::unique_ptr<Connection> connection(new Connection);
+        connection->client = client;
+        connection->reader = std::thread(readSocket, descriptor, std::move(client), std::ref(*connection), std::ref(queue));
+        connections.push_back(std::move(connection));
+    }
+
+    // The workers keep taking requests meanwhile, so a reader waiting for room in the queue still gets to stop
+    for (std::unique_ptr<Connection>& connection : connections)
+    {
+        if (std::shared_ptr<Client> client = connection->client.lock()) client->stopReading();
+        connection->reader.join();
+    }
+
+    queue.close();
+    pool.join();
+    ::close(listener);
+    return false;
+#endif
+}
@@ -0,0 +1,304 @@
+/**
+* Author: Ryley Robinson
+*
+* stats.cpp: Per-thread counters and phase timers, and their output formats. Declared in stats.h.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include "stats.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#include <intrin.h>
+#endif
+
+std::atomic<bool> Stats::Detail::on{ false };
+
+namespace
+{
+    using namespace Stats;
+
+    const char* counterNames[nCounters] = {
+        "boards_created",
+        "create_retries",
+        "removal_attempts",
+        "removals_rejected",
+        "boards_solved",
+        "search_fallbacks",
+        "technique_rounds",
+        "requests",
+        "request_errors"
+    };
+
+    // Same order as humanTechniques
+    const char* techniqueNames[maxTechniques] = {
+        "ruled_out_digits",
+        "hidden_singles",
+        "pointing_pairs",
+        "box_line_reduction",
+        "naked_pairs",
+        "hidden_pairs",
+        "x_wing",
+        "swordfish"
+    };
+
+    const char* phaseNames[nPhases] = {
+        "create_board",
+        "randomize",
+        "remove_digits",
+        "uniqueness_check",
+        "solve_board",
+        "singles"
+    };
+
+    // Only the thread that owns a block writes to it, so a plain load and store is enough, and costs the same as
+    // an ordinary increment. Other threads may read it at any time.
+    void bump(std::atomic<uint64_t>& value_, uint64_t n_)
+    {
+        value_.store(value_.load(std::memory_order_relaxed) + n_, std::memory_order_relaxed);
+    }
+
+    struct PhaseCounts
+    {
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> nanos;
+        std::atomic<uint64_t> maxNanos;
+        std::atomic<uint64_t> buckets[nBuckets];
+    };
+
+    // The counts of one thread, on cache lines of their own
+    struct alignas(64) ThreadCounts
+    {
+        std::atomic<uint64_t> counters[nCounters];
+        PhaseCounts phases[nPhases];
+    };
+
+    void addTo(Snapshot& snapshot_, const ThreadCounts& counts_)
+    {
+        for (int c = 0; c < nCounters; c++) snapshot_.counters[c] += counts_.counters[c].load(std::memory_order_relaxed);
+
+        for (int p = 0; p < nPhases; p++)
+        {
+            PhaseTotals& totals = snapshot_.phases[p];
+            const PhaseCounts& counts = counts_.phases[p];
+
+            totals.count += counts.count.load(std::memory_order_relaxed);
+            totals.nanos += counts.nanos.load(std::memory_order_relaxed);
+            totals.maxNanos = std::max(totals.maxNanos, counts.maxNanos.load(std::memory_order_relaxed));
+            for (int b = 0; b < nBuckets; b++) totals.buckets[b] += counts.buckets[b].load(std::memory_order_relaxed);
+        }
+    }
+
+    struct Registry
+    {
+        std::mutex lock;
+        std::vector<ThreadCounts*> live;
+
+        // Everything counted by threads that have finished
+        Snapshot retired;
+    };
+
+    // Set by enable() before it turns the statistics on
+    double nanosPerTick = 1;
+
+    // Never destroyed, so threads still running while the program exits can keep counting
+    Registry& registry()
+    {
+        static Registry* registry = new Registry;
+        return *registry;
+    }
+
+    // Folds the counts of a thread into the retired totals when it exits
+    struct ThreadSlot
+    {
+        ThreadCounts* counts = nullptr;
+
+        ~ThreadSlot()
+        {
+            if (!counts) return;
+
+            Registry& stats = registry();
+            std::lock_guard<std::mutex> guard(stats.lock);
+
+            addTo(stats.retired, *counts);
+            stats.live.erase(std::find(stats.live.begin(), stats.live.end(), counts));
+            delete counts;
+        }
+    };
+
+    thread_local ThreadSlot slot;
+
+    ThreadCounts& threadCounts()
+    {
+        if (!slot.counts)
+        {
+            ThreadCounts* counts = new ThreadCounts();
+
+            Registry& stats = registry();
+            std::lock_guard<std::mutex> guard(stats.lock);
+            stats.live.push_back(counts);
+            slot.counts = counts;
+        }
+        return *slot.counts;
+    }
+
+    // Number of bits needed to hold value_: the smallest b with value_ < 2^b
+    int bitWidth(uint64_t value_)
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long index;
+        return _BitScanReverse64(&index, value_) ? static_cast<int>(index) + 1 : 0;
+#elif defined(__GNUC__) || defined(__clang__)
+        return value_ == 0 ? 0 : 64 - __builtin_clzll(value_);
+#else
+        int width = 0;
+        while (width < 64 && (value_ >> width) != 0) width++;
+        return width;
+#endif
+    }
+
+    // Bucket of a time, limited to the last bucket
+    int bucketOf(uint64_t nanos_)
+    {
+        return std::min(bitWidth(nanos_), nBuckets - 1);
+    }
+
+    void writeSeconds(std::ostream& out_, uint64_t nanos_)
+    {
+        out_ << static_cast<double>(nanos_) * 1e-9;
+    }
+}
+
+void Stats::enable()
+{
+#if defined(SUDOKU_STATS_TSC)
+    // Count ticks over a couple of milliseconds of the steady clock
+    auto start = std::chrono::steady_clock::now();
+    uint64_t startTicks = Detail::ticks();
+    auto end = start;
+    while (end - start < std::chrono::milliseconds(2)) end = std::chrono::steady_clock::now();
+    uint64_t endTicks = Detail::ticks();
+
+    double nanos = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    nanosPerTick = endTicks > startTicks ? nanos / static_cast<double>(endTicks - startTicks) : 1;
+#else
+    typedef std::chrono::steady_clock::period Period;
+    nanosPerTick = 1e9 * Period::num / Period::den;
+#endif
+
+    Detail::on.store(true);
+}
+
+bool Stats::enabled()
+{
+    return Detail::on.load(std::memory_order_relaxed);
+}
+
+void Stats::Detail::add(Counter counter_, uint64_t n_)
+{
+    bump(threadCounts().counters[static_cast<int>(counter_)], n_);
+}
+
+void Stats::Detail::record(Phase phase_, uint64_t ticks_)
+{
+    uint64_t nanos = static_cast<uint64_t>(static_cast<double>(ticks_) * nanosPerTick);
+    PhaseCounts& counts = threadCounts().phases[static_cast<int>(phase_)];
+
+    bump(counts.count, 1);
+    bump(counts.nanos, nanos);
+    bump(counts.buckets[bucketOf(nanos)], 1);
+    if (nanos > counts.maxNanos.load(std::memory_order_relaxed)) counts.maxNanos.store(nanos, std::memory_order_relaxed);
+}
+
+Stats::Snapshot Stats::collect()
+{
+    Registry& stats = registry();
+    std::lock_guard<std::mutex> guard(stats.lock);
+
+    Snapshot snapshot = stats.retired;
+    for (const ThreadCounts* counts : stats.live) addTo(snapshot, *counts);
+    return snapshot;
+}
+
+const char* Stats::counterName(Counter counter_)
+{
+    return counterNames[static_cast<int>(counter_)];
+}
+
+const char* Stats::phaseName(Phase phase_)
+{
+    int p = static_cast<int>(phase_);
+    int first = static_cast<int>(Phase::Technique);
+
+    if (p >= first && p < first + maxTechniques) return techniqueNames[p - first];
+    if (phase_ == Phase::Search) return "search";
+    if (phase_ == Phase::Request) return "request";
+    return phaseNames[p];
+}
+
+void Stats::writeJson(const Snapshot& snapshot_, std::ostream& out_)
+{
+    out_ << "{\"counters\":{";
+    for (int c = 0; c < nCounters; c++)
+    {
+        out_ << (c > 0 ? "," : "") << '"' << counterName(static_cast<Counter>(c)) << "\":" << snapshot_.counters[c];
+    }
+
+    out_ << "},\"phases\":{";
+    for (int p = 0; p < nPhases; p++)
+    {
+        const PhaseTotals& totals = snapshot_.phases[p];
+
+        out_ << (p > 0 ? "," : "") << '"' << phaseName(static_cast<Phase>(p)) << "\":{\"count\":" << totals.count << ",\"seconds\":";
+        writeSeconds(out_, totals.nanos);
+        out_ << ",\"max_seconds\":";
+        writeSeconds(out_, totals.maxNanos);
+        out_ << '}';
+    }
+    out_ << "}}";
+}
+
+void Stats::writePrometheus(const Snapshot& snapshot_, std::ostream& out_)
+{
+    for (int c = 0; c < nCounters; c++)
+    {
+        const char* name = counterName(static_cast<Counter>(c));
+        out_ << "# TYPE sudoku_" << name << "_total counter\n";
+        out_ << "sudoku_" << name << "_total " << snapshot_.counters[c] << '\n';
+    }
+
+    // Buckets from 256 ns to about a second, a factor of four apart. Each one counts every time below its bound.
+    out_ << "# HELP sudoku_phase_seconds Time spent in each phase of generating and solving boards.\n";
+    out_ << "# TYPE sudoku_phase_seconds histogram\n";
+    for (int p = 0; p < nPhases; p++)
+    {
+        const PhaseTotals& totals = snapshot_.phases[p];
+        const char* name = phaseName(static_cast<Phase>(p));
+
+        uint64_t cumulative = 0;
+        int b = 0;
+        for (int bound = 8; bound <= 30; bound += 2)
+        {
+            for (; b <= bound; b++) cumulative += totals.buckets[b];
+            out_ << "sudoku_phase_seconds_bucket{phase=\"" << name << "\",le=\"";
+            writeSeconds(out_, uint64_t(1) << bound);
+            out_ << "\"} " << cumulative << '\n';
+        }
+        out_ << "sudoku_phase_seconds_bucket{phase=\"" << name << "\",le=\"+Inf\"} " << totals.count << '\n';
+        out_ << "sudoku_phase_seconds_sum{phase=\"" << name << "\"} ";
+        writeSeconds(out_, totals.nanos);
+        out_ << '\n';
+        out_ << "sudoku_phase_seconds_count{phase=\"" << name << "\"} " << totals.count << '\n';
+    }
+
+    out_ << "# HELP sudoku_phase_max_seconds Longest single time spent in each phase.\n";
+    out_ << "# TYPE sudoku_phase_max_seconds gauge\n";
+    for (int p = 0; p < nPhases; p++)
+    {
+        out_ << "sudoku_phase_max_seconds{phase=\"" << phaseName(static_cast<Phase>(p)) << "\"} ";
+        writeSeconds(out_, snapshot_.phases[p].maxNanos);
+        out_ << '\n';
+    }
+}
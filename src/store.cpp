@@ -0,0 +1,191 @@
+/**
+* Author: Ryley Robinson
+*
+* store.cpp: Reading and writing the on-disk puzzle database. Declared in store.h.
+*/
+
+#include <cstring>
+#include "store.h"
+
+#if defined(_WIN32)
+#define SUDOKU_STORE_READ 1
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char storeMagic[8] = { 'S', 'U', 'D', 'O', 'K', 'U', 'D', 'B' };
+    const uint32_t storeVersion = 1;
+
+    // The file format is little-endian, and records are read in place, so the host has to be little-endian too
+    bool hostIsLittleEndian()
+    {
+        const uint16_t probe = 1;
+        return *reinterpret_cast<const uint8_t*>(&probe) == 1;
+    }
+
+    PuzzleStoreHeader makeHeader(uint64_t nRecords_)
+    {
+        PuzzleStoreHeader header = {};
+        std::memcpy(header.magic, storeMagic, sizeof(storeMagic));
+        header.version = storeVersion;
+        header.recordSize = sizeof(PuzzleRecord);
+        header.nRecords = nRecords_;
+        header.recordsOffset = sizeof(PuzzleStoreHeader);
+        return header;
+    }
+}
+
+void PuzzleRecord::pack(int unsolvedBoard_[9][9], int solvedBoard_[9][9], int score_)
+{
+    std::memset(this, 0, sizeof(*this));
+
+    for (int i = 0; i < 81; i++)
+    {
+        int n = solvedBoard_[i / 9][i % 9];
+        solution[i / 2] |= static_cast<uint8_t>(i % 2 == 0 ? n : n << 4);
+
+        if (unsolvedBoard_[i / 9][i % 9] != 0)
+        {
+            clues[i / 8] |= static_cast<uint8_t>(1 << (i % 8));
+            nClues++;
+        }
+    }
+
+    score = static_cast<uint16_t>(score_ < 0 ? 0 : score_ > 0xFFFF ? 0xFFFF : score_);
+}
+
+void PuzzleRecord::unpack(int unsolvedBoard_[9][9], int solvedBoard_[9][9]) const
+{
+    for (int i = 0; i < 81; i++)
+    {
+        int n = i % 2 == 0 ? solution[i / 2] & 0xF : solution[i / 2] >> 4;
+        bool given = (clues[i / 8] >> (i % 8)) & 1;
+
+        if (solvedBoard_) solvedBoard_[i / 9][i % 9] = n;
+        if (unsolvedBoard_) unsolvedBoard_[i / 9][i % 9] = given ? n : 0;
+    }
+}
+
+PuzzleStore::~PuzzleStore()
+{
+    close();
+}
+
+bool PuzzleStore::open(const std::string& path_)
+{
+    close();
+    if (!hostIsLittleEndian()) return false;
+
+#if defined(SUDOKU_STORE_READ)
+    // No mapping here, so the file is read into memory instead
+    std::ifstream file(path_, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+
+    mappingSize = static_cast<size_t>(file.tellg());
+    buffer.resize((mappingSize + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(mappingSize)))
+    {
+        close();
+        return false;
+    }
+    mapping = buffer.data();
+#else
+    int descriptor = ::open(path_.c_str(), O_RDONLY);
+    if (descriptor < 0) return false;
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(PuzzleStoreHeader)))
+    {
+        ::close(descriptor);
+        return false;
+    }
+
+    mappingSize = static_cast<size_t>(status.st_size);
+    void* address = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+
+    if (address == MAP_FAILED)
+    {
+        mappingSize = 0;
+        return false;
+    }
+    mapping = address;
+#endif
+
+    const PuzzleStoreHeader* header = static_cast<const PuzzleStoreHeader*>(mapping);
+    bool valid = mappingSize >= sizeof(PuzzleStoreHeader) &&
+        std::memcmp(header->magic, storeMagic, sizeof(storeMagic)) == 0 &&
+        header->version == storeVersion &&
+        header->recordSize == sizeof(PuzzleRecord) &&
+        header->recordsOffset % alignof(PuzzleRecord) == 0 &&
+        header->recordsOffset <= mappingSize &&
+        header->nRecords <= (mappingSize - header->recordsOffset) / sizeof(PuzzleRecord);
+
+    if (!valid)
+    {
+        close();
+        return false;
+    }
+
+    records = reinterpret_cast<const PuzzleRecord*>(static_cast<const char*>(mapping) + header->recordsOffset);
+    nRecords = static_cast<size_t>(header->nRecords);
+    return true;
+}
+
+void PuzzleStore::close()
+{
+#if !defined(SUDOKU_STORE_READ)
+    if (mapping) munmap(const_cast<void*>(mapping), mappingSize);
+#endif
+
+    buffer.clear();
+    mapping = nullptr;
+    mappingSize = 0;
+    records = nullptr;
+    nRecords = 0;
+}
+
+bool PuzzleStoreWriter::open(const std::string& path_)
+{
+    nRecords = 0;
+    if (!hostIsLittleEndian()) return false;
+
+    file.open(path_, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+
+    // Written again with the final count when the store is closed
+    PuzzleStoreHeader header = makeHeader(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return static_cast<bool>(file);
+}
+
+bool PuzzleStoreWriter::append(int unsolvedBoard_[9][9], int solvedBoard_[9][9], int score_)
+{
+    PuzzleRecord record;
+    record.pack(unsolvedBoard_, solvedBoard_, score_);
+
+    file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    if (!file) return false;
+
+    nRecords++;
+    return true;
+}
+
+bool PuzzleStoreWriter::close()
+{
+    if (!file.is_open()) return false;
+
+    PuzzleStoreHeader header = makeHeader(nRecords);
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    bool written = static_cast<bool>(file);
+    file.close();
+    return written && !file.fail();
+}
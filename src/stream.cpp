@@ -0,0 +1,284 @@
+/**
+* Author: Ryley Robinson
+*
+* stream.cpp: Headless batch solving of puzzles read from a stream. Declared in functions.h.
+*
+* Input is one puzzle per line in the common 81 character format: digits 1-9 for givens, and '0' or '.' for empty spaces.
+* Anything after the 81st character is ignored. Blank lines and lines starting with '#' are skipped.
+* Lines of exactly 256 or 625 characters are 16 x 16 or 25 x 25 puzzles, with letters from 'A' for the digits above 9.
+* Only the search engine solves those, every other engine reports them unsolved.
+* Each puzzle produces one output line of the same length: the solution, or whatever could be filled in with '.' for the rest.
+*
+* Grading reads 9 x 9 puzzles the same way, and writes each puzzle followed by its score and the hardest method it needed.
+* Counting does the same with the number of solutions of each puzzle.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "functions.h"
+
+namespace
+{
+    // Output is collected here and written in large blocks instead of line by line
+    const size_t outputBufferSize = 1 << 16;
+
+    template <int Box>
+    bool parsePuzzle(const std::string& line_, int board_[Box * Box][Box * Box])
+    {
+        const int size = Box * Box;
+        if (line_.size() < static_cast<size_t>(size * size)) return false;
+
+        for (int i = 0; i < size * size; i++)
+        {
+            int n = Grid::charToDigit(line_[i], size);
+            if (n < 0) return false;
+            board_[i / size][i % size] = n;
+        }
+
+        return true;
+    }
+
+    template <int Box>
+    void appendPuzzle(std::string& output_, int board_[Box * Box][Box * Box])
+    {
+        const int size = Box * Box;
+
+        for (int i = 0; i < size * size; i++)
+        {
+            int n = board_[i / size][i % size];
+            output_ += n == 0 ? '.' : Grid::digitChars[n];
+        }
+        output_ += '\n';
+    }
+
+    // What a stream has produced so far
+    struct StreamState
+    {
+        StreamReport report;
+
+        // Time taken by each puzzle
+        std::vector<long long> latencies;
+
+        // Collected here and written in large blocks instead of line by line
+        std::string output;
+    };
+
+    // Solves one 16 x 16 or 25 x 25 puzzle. Returns false if the line isn't one.
+    template <int Box>
+    bool solveLargePuzzle(const std::string& line_, SolveEngine engine_, StreamState& state_)
+    {
+        static thread_local int board[Box * Box][Box * Box];
+        if (!parsePuzzle<Box>(line_, board)) return false;
+
+        auto start = std::chrono::steady_clock::now();
+        bool solved = engine_ == SolveEngine::Search && solveGrid<Box>(board);
+        state_.latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+        state_.report.nPuzzles++;
+        if (solved) state_.report.nSolved++;
+        appendPuzzle<Box>(state_.output, board);
+
+        return true;
+    }
+
+    // Runs the selected engine. Returns true if the board was completely and correctly filled.
+    bool runEngine(int board_[9][9], SolveEngine engine_)
+    {
+        switch (engine_)
+        {
+        case SolveEngine::Human:
+            if (!sanityCheck(board_)) return false;
+            solveBoard(board_);
+            break;
+        case SolveEngine::Dlx:
+            return dlxSolve(board_);
+        case SolveEngine::Iterative:
+        {
+            static thread_local SearchEngine engine;
+            if (!engine.load(board_) || engine.run() != SearchStatus::Solved) return false;
+            engine.store(board_);
+            return true;
+        }
+        case SolveEngine::Parallel:
+            return parallelSolve(board_);
+        case SolveEngine::Search:
+        case SolveEngine::Batch:
+            return searchSolve(board_);
+        }
+
+        for (int i = 0; i < 81; i++)
+        {
+            if (board_[i / 9][i % 9] == 0) return false;
+        }
+        return sanityCheck(board_);
+    }
+
+    double percentile(std::vector<long long>& nanos_, double fraction_)
+    {
+        if (nanos_.empty()) return 0;
+
+        size_t k = static_cast<size_t>(fraction_ * (nanos_.size() - 1));
+        std::nth_element(nanos_.begin(), nanos_.begin() + k, nanos_.end());
+        return nanos_[k] / 1000.0;
+    }
+
+    /*
+    * Reads in_ one line at a time, skips blank lines and comments, and hands every other line to puzzle_(line, state),
+    * which returns false if the line is malformed. finish_(state) is called after the last line, for any puzzles still
+    * pending. Output is written to out_ whenever a block of it is full, and once more at the end.
+    */
+    template <typename Puzzle, typename Finish>
+    StreamReport runStream(std::istream& in_, std::ostream& out_, Puzzle puzzle_, Finish finish_)
+    {
+        StreamState state;
+        std::string line;
+
+        // Room for a full block and the largest group of lines added before it is written
+        state.output.reserve(outputBufferSize + 16 * 626);
+
+        auto start = std::chrono::steady_clock::now();
+        long long lineNumber = 0;
+
+        while (std::getline(in_, line))
+        {
+            lineNumber++;
+
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty() || line[0] == '#') continue;
+
+            if (!puzzle_(line, state))
+            {
+                std::cerr << "Skipping malformed puzzle on line " << lineNumber << "." << std::endl;
+                state.report.nMalformed++;
+            }
+
+            if (state.output.size() >= outputBufferSize)
+            {
+                out_.write(state.output.data(), state.output.size());
+                state.output.clear();
+            }
+        }
+
+        finish_(state);
+
+        out_.write(state.output.data(), state.output.size());
+        out_.flush();
+
+        state.report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        state.report.p50Micros = percentile(state.latencies, 0.50);
+        state.report.p99Micros = percentile(state.latencies, 0.99);
+
+        return state.report;
+    }
+
+    // Times one puzzle of a stream that handles them one at a time
+    template <typename Work>
+    auto timed(StreamState& state_, Work work_)
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto result = work_();
+        state_.latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        return result;
+    }
+}
+
+StreamReport solveStream(std::istream& in_, std::ostream& out_, SolveEngine engine_)
+{
+    // Puzzles waiting to be solved. Every engine but the batch solver takes them one at a time.
+    const int groupSize = engine_ == SolveEngine::Batch ? 16 : 1;
+    int boards[16][9][9];
+    bool solved[16];
+    int nPending = 0;
+
+    auto solvePending = [&](StreamState& state_)
+    {
+        if (nPending == 0) return;
+
+        auto groupStart = std::chrono::steady_clock::now();
+        if (engine_ == SolveEngine::Batch) batchSolve(boards, nPending, solved);
+        else solved[0] = runEngine(boards[0], engine_);
+        long long nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - groupStart).count();
+
+        for (int p = 0; p < nPending; p++)
+        {
+            // A batch is solved together, so each of its puzzles is charged an equal share of the time
+            state_.latencies.push_back(nanos / nPending);
+
+            state_.report.nPuzzles++;
+            if (solved[p]) state_.report.nSolved++;
+
+            appendPuzzle<3>(state_.output, boards[p]);
+        }
+        nPending = 0;
+    };
+
+    auto puzzle = [&](const std::string& line_, StreamState& state_)
+    {
+        if (line_.size() == 256 || line_.size() == 625)
+        {
+            // Larger boards are solved on their own, after everything read before them
+            solvePending(state_);
+            return line_.size() == 256 ? solveLargePuzzle<4>(line_, engine_, state_) : solveLargePuzzle<5>(line_, engine_, state_);
+        }
+
+        if (!parsePuzzle<3>(line_, boards[nPending])) return false;
+        if (++nPending == groupSize) solvePending(state_);
+        return true;
+    };
+
+    return runStream(in_, out_, puzzle, solvePending);
+}
+
+StreamReport gradeStream(std::istream& in_, std::ostream& out_)
+{
+    int board[9][9];
+
+    auto puzzle = [&](const std::string& line_, StreamState& state_)
+    {
+        if (!parsePuzzle<3>(line_, board)) return false;
+
+        GradeReport grade;
+        int score = timed(state_, [&]() { return gradeBoard(board, &grade); });
+
+        state_.report.nPuzzles++;
+        if (grade.solved) state_.report.nSolved++;
+
+        std::string& output = state_.output;
+        appendPuzzle<3>(output, board);
+        output.back() = ' ';
+        output += std::to_string(score);
+        output += ' ';
+        output += !grade.solved ? "search" : grade.hardest < 0 ? "singles" : humanTechniques[grade.hardest].name;
+        output += '\n';
+        return true;
+    };
+
+    return runStream(in_, out_, puzzle, [](StreamState&) {});
+}
+
+StreamReport countStream(std::istream& in_, std::ostream& out_, long long limit_)
+{
+    int board[9][9];
+
+    auto puzzle = [&](const std::string& line_, StreamState& state_)
+    {
+        if (!parsePuzzle<3>(line_, board)) return false;
+
+        long long nSolutions = timed(state_, [&]() { return parallelCountSolutions(board, limit_); });
+
+        state_.report.nPuzzles++;
+        if (nSolutions == 1) state_.report.nSolved++;
+
+        std::string& output = state_.output;
+        appendPuzzle<3>(output, board);
+        output.back() = ' ';
+        output += std::to_string(nSolutions);
+        output += '\n';
+        return true;
+    };
+
+    return runStream(in_, out_, puzzle, [](StreamState&) {});
+}
@@ -1,61 +1,605 @@
-/**
-* Author: Ryley Robinson
-* Version: 3.0
-* 
-* Sudoku2.cpp: Start with a "seed" board that is known to be a valid sudoku board.
-* New sudoku boards can be generated by certain transformations that preserve sudoku-validity:
-* Swap groups of 3 rows/columns, and swap rows/columns within a group of 3.
-* Once a new solution is generated, remove numbers randomly to generate a starting board.
-* Use a backtracking algorithm to check that the solution generated has a single solution.
-* Use various human solving algorithms to solve the starting board.
-*
-* Entry point is the main() function.
-*/
-
-/**
-* TODO:
-* - Add new algorithm steps?
-*/
-
-/**
-* Sudoku solving algorithm:
-*
-* - Fill in all possible digits in each space of the board.
-* - Spaces with only one possible digit are solved.
-* - Search for naked pairs. Remove possibilities eliminated by naked pairs.
-* - Repeat until puzzle is solved or no options remain.
-*/
-
-#include <cstdlib>
-#include <time.h>
-#include <iostream>
-#include <math.h>
-#include <string>
-#include <vector>
-#include "config.h"
-#include "functions.h"
-
-/*
-* Entry point for program.
-* Initializes the random number generator and runs the main loop.
-*/
-int main()
-{
-    srand(static_cast<unsigned int>(time(NULL)));
-
-    do
-    {
-        while (!createBoard(Conf::nDigitsToRemove, Conf::seedBoard, Conf::solvedBoard, Conf::unsolvedBoard))
-        {
-            continue;
-        }
-        std::cout << "\nCreated board:" << std::endl;
-        printBoard(Conf::unsolvedBoard);
-
-        std::cout << "\nAttempted solution:" << std::endl;
-        solveBoard(Conf::unsolvedBoard);
-        printBoard(Conf::unsolvedBoard);
-        std::string outcome = checkSolution(Conf::solvedBoard, Conf::unsolvedBoard) ? "\nSolution is correct!" : "\nSolution is incorrect!";
-        std::cout << outcome << std::endl;
-    } while (runAgainCheck());
+/**
+* Author: Ryley Robinson
+* Version: 3.0
+* 
+* Sudoku2.cpp: Start with a "seed" board that is known to be a valid sudoku board.
+* New sudoku boards can be generated by certain transformations that preserve sudoku-validity:
+* Swap groups of 3 rows/columns, and swap rows/columns within a group of 3.
+* Once a new solution is generated, remove numbers randomly to generate a starting board.
+* Use a backtracking algorithm to check that the solution generated has a single solution.
+* Use various human solving algorithms to solve the starting board.
+*
+* Entry point is the main() function.
+*/
+
+/**
+* TODO:
+* - Add new algorithm steps?
+*/
+
+/**
+* Sudoku solving algorithm:
+*
+* - Fill in all possible digits in each space of the board.
+* - Spaces with only one possible digit are solved.
+* - Search for naked pairs. Remove possibilities eliminated by naked pairs.
+* - Repeat until puzzle is solved or no options remain.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <cstdlib>
+#include <time.h>
+#include <fstream>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+#include "config.h"
+#include "enumerate.h"
+#include "functions.h"
+#include "service.h"
+#include "stats.h"
+#include "store.h"
+#include "trace.h"
+
+void printGenerateReport(const GenerateReport& report_)
+{
+    std::cout << "\nGenerated a " << report_.nClues << " clue board in " << report_.seconds * 1000 << " ms: "
+        << report_.nAttempts << " removals tried, " << report_.nBacktracks << " backtracks, "
+        << report_.nRestarts << " restarts." << std::endl;
+}
+
+/*
+* Main loop for boards larger than 9 x 9. The human methods only know 9 x 9 boards, so these are solved by the search.
+*/
+template <int Box>
+void runLargeBoards(int nClues_)
+{
+    static int seedBoard[Box * Box][Box * Box], solvedBoard[Box * Box][Box * Box], unsolvedBoard[Box * Box][Box * Box];
+    patternGrid<Box>(seedBoard);
+    Rng rng(rand());
+
+    do
+    {
+        GenerateReport report;
+        if (!generateGrid<Box>(nClues_, seedBoard, solvedBoard, unsolvedBoard, rng, &report)) std::cout << "\nGave up before reaching " << nClues_ << " clues." << std::endl;
+        printGenerateReport(report);
+
+        std::cout << "\nCreated board:" << std::endl;
+        printGrid<Box>(unsolvedBoard);
+
+        std::cout << "\nAttempted solution:" << std::endl;
+        bool solved = solveGrid<Box>(unsolvedBoard);
+        printGrid<Box>(unsolvedBoard);
+
+        bool correct = solved;
+        for (int i = 0; i < Box * Box * Box * Box; i++)
+        {
+            if (unsolvedBoard[i / (Box * Box)][i % (Box * Box)] != solvedBoard[i / (Box * Box)][i % (Box * Box)]) correct = false;
+        }
+        std::cout << (correct ? "\nSolution is correct!" : "\nSolution is incorrect!") << std::endl;
+    } while (runAgainCheck());
+}
+
+/*
+* Generates nPuzzles_ distinct boards on every thread, grades them and writes them to a puzzle store. Returns the exit code.
+*/
+int generateStore(const std::string& path_, int nPuzzles_)
+{
+    const int chunkSize = 4096;
+    std::vector<GeneratedPuzzle> puzzles(static_cast<size_t>(std::min(nPuzzles_, chunkSize)));
+    std::vector<Board> solvedBoards(puzzles.size());
+    std::unique_ptr<bool[]> valid(new bool[puzzles.size()]);
+    uint64_t seed = static_cast<uint64_t>(rand());
+    auto start = std::chrono::steady_clock::now();
+
+    PuzzleStoreWriter writer;
+    if (!writer.open(path_))
+    {
+        std::cerr << "Could not create \"" << path_ << "\"." << std::endl;
+        return 1;
+    }
+
+    // Generated a chunk at a time, so memory stays flat however many puzzles are asked for.
+    // Boards equivalent to any earlier one, in the same chunk or not, are left out.
+    CanonicalSet seen;
+    int nWritten = 0, nInvalid = 0;
+    for (int first = 0; first < nPuzzles_; first += chunkSize)
+    {
+        int count = std::min(chunkSize, nPuzzles_ - first);
+        int nKept = generateBatch(count, Conf::nDigitsToRemove, Conf::seedBoard, puzzles.data(), seed + static_cast<uint64_t>(first), 0, SolverBackend::Search, &seen);
+
+        // Nothing goes into the store without a valid solution
+        for (int i = 0; i < nKept; i++) solvedBoards[i].load(puzzles[i].solved);
+        nInvalid += nKept - sanityCheckBatch(solvedBoards.data(), nKept, valid.get());
+
+        for (int i = 0; i < nKept; i++)
+        {
+            if (!valid[i]) continue;
+
+            nWritten++;
+            if (!writer.append(puzzles[i].unsolved, puzzles[i].solved, gradeBoard(puzzles[i].unsolved)))
+            {
+                std::cerr << "Could not write to \"" << path_ << "\"." << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    if (!writer.close())
+    {
+        std::cerr << "Could not write to \"" << path_ << "\"." << std::endl;
+        return 1;
+    }
+
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    std::cerr << "Wrote " << nWritten << " puzzles to \"" << path_ << "\" in " << seconds.count() << " s." << std::endl;
+    if (nInvalid > 0) std::cerr << "Left out " << nInvalid << " boards with an invalid solution." << std::endl;
+    return nInvalid == 0 ? 0 : 1;
+}
+
+/*
+* Opens a puzzle store and writes its puzzles to stdout, one 81 character line each, so they can be piped into --solve.
+* Returns the exit code.
+*/
+int readStore(const std::string& path_)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    PuzzleStore store;
+    if (!store.open(path_))
+    {
+        std::cerr << "Could not open \"" << path_ << "\" as a puzzle store." << std::endl;
+        return 1;
+    }
+
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    std::cerr << "Opened " << store.size() << " puzzles in " << seconds.count() * 1000 << " ms." << std::endl;
+
+    std::ios::sync_with_stdio(false);
+    int unsolvedBoard[9][9];
+    std::string line(81, '0');
+    for (size_t i = 0; i < store.size(); i++)
+    {
+        store.record(i).unpack(unsolvedBoard, nullptr);
+        for (int j = 0; j < 81; j++) line[j] = Grid::digitChars[unsolvedBoard[j / 9][j % 9]];
+        std::cout << line << '\n';
+    }
+    std::cout.flush();
+
+    return 0;
+}
+
+/*
+* Writes every solution of the first puzzle in input_ (or stdin if "-") to a solution file, stopping after limit_ of
+* them unless it is 0. Returns the exit code.
+*/
+int enumerateToFile(const std::string& input_, const std::string& path_, long long limit_)
+{
+    std::ifstream file;
+    if (input_ != "-")
+    {
+        file.open(input_);
+        if (!file)
+        {
+            std::cerr << "Could not open \"" << input_ << "\"." << std::endl;
+            return 1;
+        }
+    }
+    std::istream& in = input_ == "-" ? std::cin : file;
+
+    // The first line that isn't blank or a comment has to be the puzzle
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty() && line[0] != '#') break;
+    }
+
+    Board puzzle;
+    bool parsed = line.size() >= 81;
+    for (int i = 0; parsed && i < 81; i++)
+    {
+        int n = Grid::charToDigit(line[i], 9);
+        parsed = n >= 0;
+        puzzle.cells[i] = static_cast<uint8_t>(n);
+    }
+    if (!parsed)
+    {
+        std::cerr << "Expected an 81 character puzzle in \"" << input_ << "\"." << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    SolutionWriter writer;
+    if (!writer.open(path_, puzzle))
+    {
+        std::cerr << "Could not create \"" << path_ << "\"." << std::endl;
+        return 1;
+    }
+
+    bool written = true;
+    long long nSolutions = enumerateSolutions(puzzle, [&](const Board& solution_) { return written = writer.append(solution_); }, limit_);
+
+    if (!writer.close() || !written)
+    {
+        std::cerr << "Could not write to \"" << path_ << "\"." << std::endl;
+        return 1;
+    }
+
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    std::cerr << "Wrote " << nSolutions << " solutions of " << writer.recordSize() << " bytes each to \"" << path_ << "\" in "
+        << seconds.count() << " s." << std::endl;
+    return 0;
+}
+
+/*
+* Writes every solution in a solution file to stdout, one 81 character line each. Returns the exit code.
+*/
+int readSolutions(const std::string& path_)
+{
+    SolutionReader reader;
+    if (!reader.open(path_))
+    {
+        std::cerr << "Could not open \"" << path_ << "\" as a solution file." << std::endl;
+        return 1;
+    }
+
+    std::cerr << "Reading " << reader.size() << " solutions." << std::endl;
+
+    std::ios::sync_with_stdio(false);
+    Board solution;
+    std::string line(82, '\n');
+    while (reader.next(solution))
+    {
+        for (int i = 0; i < 81; i++) line[i] = Grid::digitChars[solution.cells[i]];
+        std::cout << line;
+    }
+    std::cout.flush();
+
+    return 0;
+}
+
+// Output format of --stats, written by writeStats when the program exits
+bool statsPrometheus = false;
+
+void writeStats()
+{
+    if (statsPrometheus) Stats::writePrometheus(Stats::collect(), std::cerr);
+    else
+    {
+        Stats::writeJson(Stats::collect(), std::cerr);
+        std::cerr << '\n';
+    }
+    std::cerr.flush();
+}
+
+/*
+* Entry point for program.
+* Initializes the random number generator, reads the command line options and runs the main loop.
+*
+* Options:
+* --backend search|dlx         Exact solver used to check that generated boards are well-posed.
+* --compare-backends [n]       Checks that both exact solvers agree on n derived puzzles (default 1000), then exits.
+* --solve [file]               Solves every puzzle in file (or stdin if omitted or "-") without prompting, then exits.
+* --engine human|search|dlx|batch|iterative|parallel  Solver used by --solve. Defaults to search.
+* --grade [file]               Grades every puzzle in file (or stdin if omitted or "-") by the human methods it needs, then exits.
+* --generate-store file n      Generates and grades n boards on every thread, writes them to a puzzle store, then exits.
+* --read-store file            Writes every puzzle in a puzzle store to stdout, one line each, then exits.
+* --count-solutions [file]     Counts the solutions of every puzzle in file (or stdin if omitted or "-") on every core, then exits.
+* --enumerate file out         Writes every solution of the first puzzle in file (or stdin if "-") to a solution file, then exits.
+* --read-solutions file        Writes every solution in a solution file to stdout, one line each, then exits.
+* --max-solutions n            Solutions --count-solutions and --enumerate stop at. Defaults to no limit.
+* --serve [socket]             Answers solve, grade and generate requests from stdin (or "-"), or from a Unix socket.
+* --workers n                  Worker threads for --serve. Defaults to one per core.
+* --queue n                    Requests --serve holds before it stops reading. Defaults to 1024.
+* --node-limit n               Search nodes a --serve solve request may visit before it is answered with an error.
+* --time-limit ms              Milliseconds a --serve solve request may search before it is answered with an error.
+* --difficulty min-max         Generates boards the human methods grade from min to max.
+* --clues n|minimal            Generates boards with n clues, or minimal boards that no clue can be removed from.
+* --box 3|4|5                  Generates and solves 9 x 9 (default), 16 x 16 or 25 x 25 boards in the main loop.
+* --stats json|prometheus      Counts and times each phase of generating and solving, and writes the totals to stderr on exit.
+* --trace-file file            Appends the debug trace to file instead of stderr. Needs a SUDOKU_TRACE build.
+* --trace-ring n               Keeps the last n trace lines in memory and writes them to stderr on exit. Needs a SUDOKU_TRACE build.
+*/
+int main(int argc, char* argv[])
+{
+    srand(static_cast<unsigned int>(time(NULL)));
+
+    SolverBackend backend = SolverBackend::Search;
+    SolveEngine engine = SolveEngine::Search;
+    int box = 3;
+
+    // Target number of clues. -1 removes Conf::nDigitsToRemove digits, 0 makes minimal boards.
+    int nClues = -1;
+    bool solveMode = false, gradeMode = false, countMode = false;
+    long long maxSolutions = 0;
+    std::string enumeratePath;
+    int minScore = -1, maxScore = -1;
+    std::string solveInput = "-";
+    bool serveMode = false;
+    std::string serveSocketPath = "-";
+    ServiceOptions serviceOptions;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = argv[i];
+
+        if (option == "--backend" && i + 1 < argc)
+        {
+            std::string name = argv[++i];
+            if (name != "search" && name != "dlx")
+            {
+                std::cout << "Unknown backend \"" << name << "\". Expected \"search\" or \"dlx\"." << std::endl;
+                return 1;
+            }
+            backend = name == "dlx" ? SolverBackend::Dlx : SolverBackend::Search;
+        }
+        else if (option == "--box" && i + 1 < argc)
+        {
+            box = atoi(argv[++i]);
+            if (box < 3 || box > 5)
+            {
+                std::cout << "Unsupported box size \"" << argv[i] << "\". Expected 3, 4 or 5." << std::endl;
+                return 1;
+            }
+        }
+        else if (option == "--clues" && i + 1 < argc)
+        {
+            std::string value = argv[++i];
+            nClues = value == "minimal" ? 0 : atoi(value.c_str());
+            if (nClues <= 0 && value != "minimal")
+            {
+                std::cout << "Unknown clue count \"" << value << "\". Expected a number or \"minimal\"." << std::endl;
+                return 1;
+            }
+        }
+        else if (option == "--difficulty" && i + 1 < argc)
+        {
+            std::string value = argv[++i];
+            size_t dash = value.find('-');
+            minScore = atoi(value.substr(0, dash).c_str());
+            maxScore = dash == std::string::npos ? minScore : atoi(value.substr(dash + 1).c_str());
+            if (dash == 0 || minScore < 0 || maxScore < minScore)
+            {
+                std::cout << "Unknown difficulty \"" << value << "\". Expected a score range such as \"20-40\"." << std::endl;
+                return 1;
+            }
+        }
+        else if (option == "--compare-backends")
+        {
+            int nPuzzles = i + 1 < argc ? atoi(argv[i + 1]) : 0;
+            return compareBackends(nPuzzles > 0 ? nPuzzles : 1000, Conf::seedBoard) == 0 ? 0 : 1;
+        }
+        else if (option == "--generate-store" && i + 2 < argc)
+        {
+            int nPuzzles = atoi(argv[i + 2]);
+            if (nPuzzles <= 0)
+            {
+                std::cout << "Unknown puzzle count \"" << argv[i + 2] << "\"." << std::endl;
+                return 1;
+            }
+            return generateStore(argv[i + 1], nPuzzles);
+        }
+        else if (option == "--read-store" && i + 1 < argc)
+        {
+            return readStore(argv[i + 1]);
+        }
+        else if (option == "--read-solutions" && i + 1 < argc)
+        {
+            return readSolutions(argv[i + 1]);
+        }
+        else if (option == "--enumerate" && i + 2 < argc)
+        {
+            solveInput = argv[++i];
+            enumeratePath = argv[++i];
+        }
+        else if (option == "--max-solutions" && i + 1 < argc)
+        {
+            maxSolutions = atoll(argv[++i]);
+            if (maxSolutions <= 0)
+            {
+                std::cout << "Unknown solution count \"" << argv[i] << "\"." << std::endl;
+                return 1;
+            }
+        }
+        else if (option == "--solve" || option == "--grade" || option == "--count-solutions")
+        {
+            solveMode = true;
+            gradeMode = option == "--grade";
+            countMode = option == "--count-solutions";
+            if (i + 1 < argc && (argv[i + 1][0] != '-' || argv[i + 1][1] == '\0')) solveInput = argv[++i];
+        }
+        else if (option == "--serve")
+        {
+            serveMode = true;
+            if (i + 1 < argc && (argv[i + 1][0] != '-' || argv[i + 1][1] == '\0')) serveSocketPath = argv[++i];
+        }
+        else if ((option == "--node-limit" || option == "--time-limit") && i + 1 < argc)
+        {
+            long long n = atoll(argv[++i]);
+            if (n <= 0)
+            {
+                std::cout << "Unknown " << (option == "--node-limit" ? "node" : "time") << " limit \"" << argv[i] << "\"." << std::endl;
+                return 1;
+            }
+            if (option == "--node-limit") serviceOptions.solveNodeLimit = n;
+            else serviceOptions.solveTimeLimit = std::chrono::milliseconds(n);
+        }
+        else if ((option == "--workers" || option == "--queue") && i + 1 < argc)
+        {
+            int n = atoi(argv[++i]);
+            if (n <= 0)
+            {
+                std::cout << "Unknown " << (option == "--workers" ? "worker" : "queue") << " count \"" << argv[i] << "\"." << std::endl;
+                return 1;
+            }
+            if (option == "--workers") serviceOptions.nWorkers = n;
+            else serviceOptions.queueCapacity = static_cast<size_t>(n);
+        }
+        else if (option == "--engine" && i + 1 < argc)
+        {
+            std::string name = argv[++i];
+            if (name == "human") engine = SolveEngine::Human;
+            else if (name == "search") engine = SolveEngine::Search;
+            else if (name == "dlx") engine = SolveEngine::Dlx;
+            else if (name == "batch") engine = SolveEngine::Batch;
+            else if (name == "iterative") engine = SolveEngine::Iterative;
+            else if (name == "parallel") engine = SolveEngine::Parallel;
+            else
+            {
+                std::cout << "Unknown engine \"" << name << "\". Expected \"human\", \"search\", \"dlx\", \"batch\", \"iterative\" or \"parallel\"." << std::endl;
+                return 1;
+            }
+        }
+        else if (option == "--stats" && i + 1 < argc)
+        {
+            std::string format = argv[++i];
+            if (format != "json" && format != "prometheus")
+            {
+                std::cout << "Unknown statistics format \"" << format << "\". Expected \"json\" or \"prometheus\"." << std::endl;
+                return 1;
+            }
+            statsPrometheus = format == "prometheus";
+            Stats::enable();
+            atexit(writeStats);
+        }
+        else if ((option == "--trace-file" || option == "--trace-ring") && i + 1 < argc)
+        {
+            std::string value = argv[++i];
+
+            if (!Trace::enabled)
+            {
+                std::cerr << "Ignoring " << option << ": tracing was not compiled in (configure with -DSUDOKU_TRACE=ON)." << std::endl;
+            }
+            else if (option == "--trace-file" && !Trace::toFile(value))
+            {
+                std::cerr << "Could not open \"" << value << "\" for tracing." << std::endl;
+                return 1;
+            }
+            else if (option == "--trace-ring")
+            {
+                Trace::toRing(static_cast<size_t>(atoi(value.c_str())));
+                atexit([]() { Trace::dumpRing(std::cerr); });
+            }
+        }
+        else
+        {
+            std::cout << "Unknown option \"" << option << "\"." << std::endl;
+            return 1;
+        }
+    }
+
+    if (serveMode)
+    {
+        serviceOptions.seedBoard = Conf::seedBoard;
+        serviceOptions.nDigitsToRemove = Conf::nDigitsToRemove;
+        serviceOptions.seed = static_cast<uint64_t>(time(NULL));
+
+        if (serveSocketPath != "-")
+        {
+            std::cerr << "Listening on \"" << serveSocketPath << "\"." << std::endl;
+            serveSocket(serveSocketPath, serviceOptions);
+            std::cerr << "Could not listen on \"" << serveSocketPath << "\"." << std::endl;
+            return 1;
+        }
+
+        std::ios::sync_with_stdio(false);
+        ServiceReport report = serveStream(std::cin, std::cout, serviceOptions);
+
+        std::cerr << "Answered " << report.nRequests << " requests (" << report.nErrors << " errors) in " << report.seconds << " s: "
+            << (report.seconds > 0 ? report.nRequests / report.seconds : 0) << " requests/s" << std::endl;
+        return 0;
+    }
+
+    if (!enumeratePath.empty()) return enumerateToFile(solveInput, enumeratePath, maxSolutions);
+
+    if (solveMode)
+    {
+        std::ios::sync_with_stdio(false);
+
+        std::ifstream file;
+        if (solveInput != "-")
+        {
+            file.open(solveInput);
+            if (!file)
+            {
+                std::cerr << "Could not open \"" << solveInput << "\"." << std::endl;
+                return 1;
+            }
+        }
+
+        std::istream& in = solveInput == "-" ? std::cin : file;
+        StreamReport report = gradeMode ? gradeStream(in, std::cout) : countMode ? countStream(in, std::cout, maxSolutions) : solveStream(in, std::cout, engine);
+
+        if (countMode) std::cerr << "Counted the solutions of " << report.nPuzzles << " puzzles, " << report.nSolved << " with exactly one";
+        else if (gradeMode) std::cerr << "Graded " << report.nPuzzles << " puzzles, " << report.nSolved << " solved by the human methods alone";
+        else std::cerr << "Solved " << report.nSolved << " of " << report.nPuzzles << " puzzles";
+        if (report.nMalformed > 0) std::cerr << " (" << report.nMalformed << " malformed lines skipped)";
+        std::cerr << " in " << report.seconds << " s: "
+            << (report.seconds > 0 ? report.nPuzzles / report.seconds : 0) << " puzzles/s, "
+            << "p50 " << report.p50Micros << " us, p99 " << report.p99Micros << " us" << std::endl;
+
+        return gradeMode || countMode || report.nSolved == report.nPuzzles ? 0 : 1;
+    }
+
+    if (box == 4)
+    {
+        runLargeBoards<4>(nClues >= 0 ? nClues : 256 - Conf::nDigitsToRemove16);
+        return 0;
+    }
+    if (box == 5)
+    {
+        runLargeBoards<5>(nClues >= 0 ? nClues : 625 - Conf::nDigitsToRemove25);
+        return 0;
+    }
+
+    Board seedBoard;
+    seedBoard.load(Conf::seedBoard);
+
+    do
+    {
+        // The targeted generators only work on ints
+        int solvedBoard[9][9], unsolvedBoard[9][9];
+
+        if (minScore >= 0)
+        {
+            GenerateReport report;
+            GradeReport grade;
+            Rng rng(rand());
+            if (!generateForDifficulty(minScore, maxScore, Conf::seedBoard, solvedBoard, unsolvedBoard, rng, &report, &grade)) std::cout << "\nGave up before reaching a score from " << minScore << " to " << maxScore << "." << std::endl;
+            printGenerateReport(report);
+            std::cout << "Difficulty score " << grade.score << ", hardest method: "
+                << (!grade.solved ? "search" : grade.hardest < 0 ? "singles" : humanTechniques[grade.hardest].name) << "." << std::endl;
+            Conf::solvedBoard.load(solvedBoard);
+            Conf::unsolvedBoard.load(unsolvedBoard);
+        }
+        else if (nClues >= 0)
+        {
+            GenerateReport report;
+            Rng rng(rand());
+            if (!generateGrid<3>(nClues, Conf::seedBoard, solvedBoard, unsolvedBoard, rng, &report)) std::cout << "\nGave up before reaching " << nClues << " clues." << std::endl;
+            printGenerateReport(report);
+            Conf::solvedBoard.load(solvedBoard);
+            Conf::unsolvedBoard.load(unsolvedBoard);
+        }
+        else
+        {
+            while (!createBoard(Conf::nDigitsToRemove, seedBoard, Conf::solvedBoard, Conf::unsolvedBoard, backend))
+            {
+                continue;
+            }
+        }
+        std::cout << "\nCreated board:" << std::endl;
+        printBoard(Conf::unsolvedBoard);
+
+        std::cout << "\nAttempted solution:" << std::endl;
+        solveBoard(Conf::unsolvedBoard);
+        printBoard(Conf::unsolvedBoard);
+        std::string outcome = checkSolution(Conf::solvedBoard, Conf::unsolvedBoard) ? "\nSolution is correct!" : "\nSolution is incorrect!";
+        std::cout << outcome << std::endl;
+    } while (runAgainCheck());
 }
\ No newline at end of file
@@ -0,0 +1,102 @@
+/**
+* Author: Ryley Robinson
+*
+* trace.cpp: Sinks for the debug trace. Declared in trace.h.
+*/
+
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
+#include "trace.h"
+
+namespace
+{
+    enum class Sink
+    {
+        Console,
+        File,
+        Ring
+    };
+
+    // Shared by every thread that traces, so all access goes through the lock
+    struct TraceState
+    {
+        std::mutex lock;
+        Sink sink = Sink::Console;
+        std::ofstream file;
+        std::vector<std::string> ring;
+        size_t ringNext = 0;
+        bool ringFull = false;
+    };
+
+    TraceState& traceState()
+    {
+        static TraceState state;
+        return state;
+    }
+}
+
+void Trace::toConsole()
+{
+    TraceState& state = traceState();
+    std::lock_guard<std::mutex> guard(state.lock);
+
+    state.sink = Sink::Console;
+}
+
+bool Trace::toFile(const std::string& path_)
+{
+    TraceState& state = traceState();
+    std::lock_guard<std::mutex> guard(state.lock);
+
+    state.file.close();
+    state.file.open(path_, std::ios::app);
+    if (!state.file) return false;
+
+    state.sink = Sink::File;
+    return true;
+}
+
+void Trace::toRing(size_t capacity_)
+{
+    TraceState& state = traceState();
+    std::lock_guard<std::mutex> guard(state.lock);
+
+    state.ring.assign(capacity_ > 0 ? capacity_ : 1, std::string());
+    state.ringNext = 0;
+    state.ringFull = false;
+    state.sink = Sink::Ring;
+}
+
+void Trace::dumpRing(std::ostream& out_)
+{
+    TraceState& state = traceState();
+    std::lock_guard<std::mutex> guard(state.lock);
+
+    size_t first = state.ringFull ? state.ringNext : 0;
+    size_t count = state.ringFull ? state.ring.size() : state.ringNext;
+    for (size_t i = 0; i < count; i++) out_ << state.ring[(first + i) % state.ring.size()] << '\n';
+    out_.flush();
+}
+
+void Trace::write(const std::string& line_)
+{
+    TraceState& state = traceState();
+    std::lock_guard<std::mutex> guard(state.lock);
+
+    switch (state.sink)
+    {
+    case Sink::Console:
+        std::clog << line_ << '\n';
+        break;
+    case Sink::File:
+        state.file << line_ << '\n';
+        break;
+    case Sink::Ring:
+        state.ring[state.ringNext] = line_;
+        state.ringNext = (state.ringNext + 1) % state.ring.size();
+        if (state.ringNext == 0) state.ringFull = true;
+        break;
+    }
+}
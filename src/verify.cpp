@@ -0,0 +1,273 @@
+/**
+* Author: Ryley Robinson
+*
+* verify.cpp: Differential check between the exact solver backends. Declared in functions.h.
+*
+* Corpus:
+* - A handful of well known puzzles, from easy up to some of the hardest known 17-clue puzzles.
+* - Puzzles derived from a solved grid by relabelling its digits and removing a random number of them.
+*   Removing many digits leaves several solutions, so solution counts get compared as well as solutions.
+* - The grids are the seed board with its bands, stacks, rows and columns shuffled and sometimes transposed, or, for
+*   every third puzzle, a grid solved from a few random digits, which owes nothing to the seed board at all.
+* - Some derived puzzles get one extra random digit, which often leaves them with no solution at all.
+*
+* The batch validator, sanityCheckBatch, is checked against sanityCheck on every puzzle of the corpus, and on boards
+* holding values past 9, which neither may accept.
+*
+* The iterative engine is checked against the same counts and solutions. A single engine is kept for the whole corpus and
+* loaded twice per puzzle, the first time over a search stopped part of the way, so every load starts from whatever
+* the last search left behind.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "functions.h"
+
+namespace
+{
+    const char* knownPuzzles[] = {
+        "..3.2.6..9..3.5..1..18.64....81.29..7.......8..67.82....26.95..8..2.3..9..5.1.3..",
+        "8..........36......7..9.2...5...7.......457.....1...3...1....68..85...1..9....4..",
+        "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......",
+        ".......1.4.........2...........5.4.7..8...3....1.9....3..4..2...5.1........8.6...",
+        ".................................................................................",
+        "11..............................................................................."
+    };
+
+    // Solution counts are compared up to this many solutions
+    const int countLimit = 64;
+
+    // Returns true if solution_ is full, has no repeats, and keeps every given digit of puzzle_
+    bool solves(int puzzle_[9][9], int solution_[9][9])
+    {
+        for (int i = 0; i < 81; i++)
+        {
+            int given = puzzle_[i / 9][i % 9], placed = solution_[i / 9][i % 9];
+            if (placed == 0 || (given != 0 && given != placed)) return false;
+        }
+
+        return sanityCheck(solution_);
+    }
+
+    // Counts solutions with an engine that has already been used, and writes the first one to solution_
+    int engineCountSolutions(SearchEngine& engine_, int puzzle_[9][9], int solution_[9][9])
+    {
+        SearchLimits limits;
+        limits.maxNodes = 3;
+        engine_.load(puzzle_);
+        engine_.run(limits);
+
+        int count = 0;
+        engine_.load(puzzle_);
+        while (count < countLimit && engine_.run() == SearchStatus::Solved)
+        {
+            if (count++ == 0) engine_.store(solution_);
+        }
+        return count;
+    }
+
+    bool backendsAgree(int puzzle_[9][9], SearchEngine& engine_)
+    {
+        int searchBoard[9][9], dlxBoard[9][9], engineBoard[9][9];
+        for (int i = 0; i < 81; i++) searchBoard[i / 9][i % 9] = dlxBoard[i / 9][i % 9] = puzzle_[i / 9][i % 9];
+
+        int searchCount = countSolutions(puzzle_, countLimit);
+        int dlxCount = dlxCountSolutions(puzzle_, countLimit);
+        bool searchSolved = searchSolve(searchBoard);
+        bool dlxSolved = dlxSolve(dlxBoard);
+        int engineCount = engineCountSolutions(engine_, puzzle_, engineBoard);
+
+        if (searchCount != dlxCount || searchCount != engineCount || searchSolved != dlxSolved || searchSolved != (searchCount > 0)) return false;
+
+        if (searchSolved && (!solves(puzzle_, searchBoard) || !solves(puzzle_, dlxBoard) || !solves(puzzle_, engineBoard))) return false;
+
+        // A well-posed puzzle has exactly one solution, so every solver must have found the same one.
+        for (int i = 0; i < 81 && searchCount == 1; i++)
+        {
+            if (searchBoard[i / 9][i % 9] != dlxBoard[i / 9][i % 9] || searchBoard[i / 9][i % 9] != engineBoard[i / 9][i % 9]) return false;
+        }
+
+        return true;
+    }
+
+    void shuffle(int* values_, int n_)
+    {
+        for (int i = n_ - 1; i > 0; i--)
+        {
+            int swapWith = rand() % (i + 1);
+            int temp = values_[i];
+            values_[i] = values_[swapWith];
+            values_[swapWith] = temp;
+        }
+    }
+
+    // An order of the 9 rows (or columns) that keeps every band together: the bands shuffled, then the rows within each
+    void shuffleLines(int lines_[9])
+    {
+        int bands[3] = { 0, 1, 2 };
+        shuffle(bands, 3);
+
+        for (int b = 0; b < 3; b++)
+        {
+            int within[3] = { 0, 1, 2 };
+            shuffle(within, 3);
+            for (int k = 0; k < 3; k++) lines_[3 * b + k] = 3 * bands[b] + within[k];
+        }
+    }
+
+    // The seed board with its rows and columns reordered, and half the time transposed
+    void transformGrid(int seedBoard_[9][9], int grid_[9][9])
+    {
+        int rows[9], cols[9];
+        shuffleLines(rows);
+        shuffleLines(cols);
+        bool transpose = rand() % 2 == 0;
+
+        for (int r = 0; r < 9; r++)
+        {
+            for (int c = 0; c < 9; c++) grid_[r][c] = transpose ? seedBoard_[rows[c]][cols[r]] : seedBoard_[rows[r]][cols[c]];
+        }
+    }
+
+    // A grid solved from a handful of random digits
+    void randomGrid(int grid_[9][9])
+    {
+        do
+        {
+            for (int i = 0; i < 81; i++) grid_[i / 9][i % 9] = 0;
+
+            for (int nPlaced = 0; nPlaced < 11;)
+            {
+                int index = rand() % 81;
+                if (grid_[index / 9][index % 9] != 0) continue;
+
+                grid_[index / 9][index % 9] = 1 + rand() % 9;
+                if (sanityCheck(grid_)) nPlaced++;
+                else grid_[index / 9][index % 9] = 0;
+            }
+        } while (!searchSolve(grid_));
+    }
+
+    void printPuzzleLine(int puzzle_[9][9])
+    {
+        for (int i = 0; i < 81; i++) std::cout << (puzzle_[i / 9][i % 9] == 0 ? '.' : static_cast<char>('0' + puzzle_[i / 9][i % 9]));
+        std::cout << std::endl;
+    }
+
+    // Boards with one space, and every space, holding a value past 9. Nine 15s in every unit once added up to the same
+    // as a single one in the 16-bit sums of the batch validator, so it passed a board sanityCheck rejected.
+    void addOutOfRange(std::vector<Board>& boards_)
+    {
+        for (int n : { 10, 15, 16, 255 })
+        {
+            Board board = {};
+            board.cells[40] = static_cast<uint8_t>(n);
+            boards_.push_back(board);
+
+            for (int i = 0; i < 81; i++) board.cells[i] = static_cast<uint8_t>(n);
+            boards_.push_back(board);
+        }
+    }
+
+    // Returns the number of boards sanityCheckBatch and sanityCheck disagree on
+    int validatorsDisagree(const std::vector<Board>& boards_)
+    {
+        std::unique_ptr<bool[]> valid(new bool[boards_.size()]);
+        sanityCheckBatch(boards_.data(), static_cast<int>(boards_.size()), valid.get());
+
+        int nMismatches = 0;
+        for (size_t b = 0; b < boards_.size(); b++)
+        {
+            if (valid[b] == sanityCheck(boards_[b])) continue;
+
+            int board[9][9];
+            boards_[b].store(board);
+            std::cout << "Validators disagree on: ";
+            printPuzzleLine(board);
+            nMismatches++;
+        }
+
+        return nMismatches;
+    }
+}
+
+int compareBackends(int nPuzzles_, int seedBoard_[9][9])
+{
+    int nMismatches = 0, nCompared = 0;
+    int puzzle[9][9];
+    SearchEngine engine;
+    std::vector<Board> boards;
+
+    for (const char* line : knownPuzzles)
+    {
+        for (int i = 0; i < 81; i++) puzzle[i / 9][i % 9] = line[i] == '.' ? 0 : line[i] - '0';
+
+        Board board;
+        board.load(puzzle);
+        boards.push_back(board);
+
+        nCompared++;
+        if (!backendsAgree(puzzle, engine))
+        {
+            std::cout << "Backends disagree on: ";
+            printPuzzleLine(puzzle);
+            nMismatches++;
+        }
+    }
+
+    for (int p = 0; p < nPuzzles_; p++)
+    {
+        int grid[9][9];
+        if (p % 3 == 2) randomGrid(grid);
+        else transformGrid(seedBoard_, grid);
+
+        // Relabel the digits of the grid
+        int labels[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+        shuffle(labels + 1, 9);
+
+        for (int i = 0; i < 81; i++) puzzle[i / 9][i % 9] = labels[grid[i / 9][i % 9]];
+
+        // Remove between 40 and 70 digits at random
+        int indices[81];
+        for (int i = 0; i < 81; i++) indices[i] = i;
+
+        int nRemove = 40 + rand() % 31;
+        for (int i = 0; i < nRemove; i++)
+        {
+            int swapWith = i + rand() % (81 - i);
+            int temp = indices[i];
+            indices[i] = indices[swapWith];
+            indices[swapWith] = temp;
+
+            puzzle[indices[i] / 9][indices[i] % 9] = 0;
+        }
+
+        // Sometimes add a random digit back in, which may break the puzzle
+        if (rand() % 4 == 0)
+        {
+            int index = indices[rand() % nRemove];
+            puzzle[index / 9][index % 9] = 1 + rand() % 9;
+        }
+
+        Board board;
+        board.load(puzzle);
+        boards.push_back(board);
+
+        nCompared++;
+        if (!backendsAgree(puzzle, engine))
+        {
+            std::cout << "Backends disagree on: ";
+            printPuzzleLine(puzzle);
+            nMismatches++;
+        }
+    }
+
+    addOutOfRange(boards);
+    nMismatches += validatorsDisagree(boards);
+
+    std::cout << "Compared " << nCompared << " puzzles: " << nMismatches << " disagreements." << std::endl;
+
+    return nMismatches;
+}